@@ -0,0 +1,707 @@
+# Generates the constexpr schema tables of src/tdr/schemaTables.hpp from schema.json,
+# with the perfect hashes of the child and attribute lookups of src/tdr/schemaLookup.hpp,
+# and the list of known symbols of src/tdr/symbols.hpp
+#
+#   cmake -DINPUT=schema.json -DOUTPUT=schemaData.hpp -DSYMBOLS=schemaSymbols.hpp -P generateSchema.cmake
+#
+# Mirrors the C++ export of schema-editor.html: same defaults, same keys,
+# includes applied after the children. Each variant also gets the tag record
+# it makes once merged into its tag, and lists are sorted as their symbols,
+# so the schema is read straight from these tables at runtime.
+
+cmake_minimum_required(VERSION 3.19)
+
+# C++ literal of the string ${value}
+function(cpp_string out value)
+	string(REPLACE "\\" "\\\\" value "${value}")
+	string(REPLACE "\"" "\\\"" value "${value}")
+	string(REPLACE "\n" "\\n" value "${value}")
+	string(REPLACE "\r" "\\r" value "${value}")
+	string(REPLACE "\t" "\\t" value "${value}")
+	set(${out} "\"${value}\"" PARENT_SCOPE)
+endfunction()
+
+# Member ${key} of ${json}, ${default} when missing or null
+function(json_get out json key default)
+	string(JSON type ERROR_VARIABLE error TYPE "${json}" ${key})
+	if (error OR type STREQUAL "NULL")
+		set(${out} "${default}" PARENT_SCOPE)
+	else()
+		string(JSON value GET "${json}" ${key})
+		set(${out} "${value}" PARENT_SCOPE)
+	endif()
+endfunction()
+
+# Member ${key} of ${json} as a C++ bool
+function(json_bool out json key)
+	json_get(value "${json}" ${key} OFF)
+	if (value)
+		set(${out} "true" PARENT_SCOPE)
+	else()
+		set(${out} "false" PARENT_SCOPE)
+	endif()
+endfunction()
+
+# Number of elements or members of ${key} in ${json}, 0 when missing or null
+function(json_length out json key)
+	string(JSON length ERROR_VARIABLE error LENGTH "${json}" ${key})
+	if (error)
+		set(length 0)
+	endif()
+	set(${out} ${length} PARENT_SCOPE)
+endfunction()
+
+# Strings of the array ${key} of ${json} as a list
+function(json_strings out json key)
+	set(values "")
+	json_length(count "${json}" ${key})
+	if (count GREATER 0)
+		math(EXPR last "${count} - 1")
+		foreach (i RANGE ${last})
+			string(JSON value GET "${json}" ${key} ${i})
+			list(APPEND values "${value}")
+		endforeach()
+	endif()
+	set(${out} "${values}" PARENT_SCOPE)
+endfunction()
+
+# Number of records in ${table}
+function(table_size out table)
+	get_property(count GLOBAL PROPERTY ${table}_count)
+	if (NOT count)
+		set(count 0)
+	endif()
+	set(${out} ${count} PARENT_SCOPE)
+endfunction()
+
+# Appends ${count} records, each a line of ${records}, to ${table}
+function(add_records table records count)
+	table_size(size ${table})
+	math(EXPR size "${size} + ${count}")
+	set_property(GLOBAL APPEND_STRING PROPERTY ${table}_records "${records}")
+	set_property(GLOBAL PROPERTY ${table}_count ${size})
+endfunction()
+
+# Appends ${record} to ${table}, its index in ${out}
+function(add_record out table record)
+	table_size(index ${table})
+	add_records(${table} "\t${record},\n" 1)
+	set(${out} ${index} PARENT_SCOPE)
+endfunction()
+
+# Range of ${indices}, appended to tagLists
+function(add_tag_list out indices)
+	table_size(begin tagLists)
+	list(LENGTH indices count)
+	foreach (index IN LISTS indices)
+		add_record(unused tagLists "${index}")
+	endforeach()
+	set(${out} "{ ${begin}, ${count} }" PARENT_SCOPE)
+endfunction()
+
+# Range of ${indices}, appended to attributeLists
+function(add_attribute_list out indices)
+	table_size(begin attributeLists)
+	list(LENGTH indices count)
+	foreach (index IN LISTS indices)
+		add_record(unused attributeLists "${index}")
+	endforeach()
+	set(${out} "{ ${begin}, ${count} }" PARENT_SCOPE)
+endfunction()
+
+# Range of the strings of the array ${key} of ${json}
+function(add_strings out json key)
+	table_size(begin strings)
+	json_length(count "${json}" ${key})
+	if (count GREATER 0)
+		math(EXPR last "${count} - 1")
+		foreach (i RANGE ${last})
+			string(JSON value GET "${json}" ${key} ${i})
+			cpp_string(literal "${value}")
+			add_record(unused strings "${literal}")
+		endforeach()
+	endif()
+	set(${out} "{ ${begin}, ${count} }" PARENT_SCOPE)
+endfunction()
+
+# C++ float literal of the JSON number ${value}
+function(cpp_float out value)
+	if (value MATCHES "^-?[0-9]+$")
+		string(APPEND value ".0")
+	endif()
+	set(${out} "${value}f" PARENT_SCOPE)
+endfunction()
+
+# "has_range, range_min, range_max" of ${json}
+function(value_range out json)
+	set(range "false, 0.0f, 0.0f")
+	json_length(count "${json}" range)
+	if (count EQUAL 2)
+		string(JSON minType TYPE "${json}" range 0)
+		string(JSON maxType TYPE "${json}" range 1)
+		if (minType STREQUAL "NUMBER" AND maxType STREQUAL "NUMBER")
+			string(JSON min GET "${json}" range 0)
+			string(JSON max GET "${json}" range 1)
+			cpp_float(min ${min})
+			cpp_float(max ${max})
+			set(range "true, ${min}, ${max}")
+		endif()
+	endif()
+	set(${out} "${range}" PARENT_SCOPE)
+endfunction()
+
+# "has_text_type, text_type" of ${json}, a type only when text is allowed
+function(text_type out json)
+	json_get(allowText "${json}" allow_text OFF)
+	json_get(type "${json}" text_type "")
+	if (allowText AND NOT type STREQUAL "")
+		set(${out} "true, ValueType::${type}" PARENT_SCOPE)
+	else()
+		set(${out} "false, ValueType::STRING" PARENT_SCOPE)
+	endif()
+endfunction()
+
+# Key of the member ${i} of the object ${key} in ${json}: its name, else its member name
+function(member_key out json key i)
+	string(JSON member MEMBER "${json}" ${key} ${i})
+	string(JSON name ERROR_VARIABLE error GET "${json}" ${key} ${member} name)
+	if (error OR name STREQUAL "")
+		set(name "${member}")
+	endif()
+	set(${out} "${name}" PARENT_SCOPE)
+endfunction()
+
+# Records the tag or attribute name ${name} as a known symbol
+function(add_symbol name)
+	if (NOT name STREQUAL "")
+		set_property(GLOBAL APPEND PROPERTY symbol_names "${name}")
+	endif()
+endfunction()
+
+# C++ identifier, named in the sym namespace rather than in TDR_OTHER_SYMBOLS
+function(is_identifier out name)
+	if (name MATCHES "^[A-Za-z_][A-Za-z0-9_]*$")
+		set(${out} TRUE PARENT_SCOPE)
+	else()
+		set(${out} FALSE PARENT_SCOPE)
+	endif()
+endfunction()
+
+# Known symbol of ${name} as a C++ constant. Those of other names only have
+# an ID once every name is known: a placeholder stands for them until then.
+function(symbol_ref out name)
+	add_symbol("${name}")
+	is_identifier(identifier "${name}")
+	if (name STREQUAL "")
+		set(${out} "sym::EMPTY" PARENT_SCOPE)
+	elseif (identifier)
+		set(${out} "sym::${name}" PARENT_SCOPE)
+	else()
+		get_property(refs GLOBAL PROPERTY symbol_refs)
+		list(FIND refs "${name}" ref)
+		if (ref EQUAL -1)
+			list(LENGTH refs ref)
+			set_property(GLOBAL APPEND PROPERTY symbol_refs "${name}")
+		endif()
+		set(${out} "@symbol_${ref}@" PARENT_SCOPE)
+	endif()
+endfunction()
+
+# Sorts ${name} as its symbol: identifiers first, as TDR_KNOWN_SYMBOLS, then the others
+function(symbol_sort_key out name)
+	is_identifier(identifier "${name}")
+	if (identifier)
+		set(${out} "0${name}" PARENT_SCOPE)
+	else()
+		set(${out} "1${name}" PARENT_SCOPE)
+	endif()
+endfunction()
+
+# The ${kind} (tag or attribute) records ${ARGN} sorted as their keys, the last one kept for a key
+function(sorted_by_key out kind)
+	set(sortKeys "")
+	foreach (index IN LISTS ARGN)
+		get_property(key GLOBAL PROPERTY ${kind}_${index}_key)
+		symbol_sort_key(sortKey "${key}")
+		list(APPEND sortKeys "${sortKey}")
+		set("record_${sortKey}" ${index})
+	endforeach()
+	list(REMOVE_DUPLICATES sortKeys)
+	list(SORT sortKeys)
+
+	set(indices "")
+	foreach (sortKey IN LISTS sortKeys)
+		list(APPEND indices ${record_${sortKey}})
+	endforeach()
+	set(${out} "${indices}" PARENT_SCOPE)
+endfunction()
+
+# Tags of the groups ${ARGN}
+function(group_tags out)
+	set(indices "")
+	foreach (group IN LISTS ARGN)
+		get_property(groupTags GLOBAL PROPERTY group_${group}_tags)
+		list(APPEND indices ${groupTags})
+	endforeach()
+	set(${out} "${indices}" PARENT_SCOPE)
+endfunction()
+
+# Attributes of ${json}, appended to attributes, their indices in ${out}
+function(add_attributes out json)
+	set(indices "")
+	json_length(count "${json}" attributes)
+	if (count GREATER 0)
+		math(EXPR last "${count} - 1")
+		foreach (i RANGE ${last})
+			string(JSON member MEMBER "${json}" attributes ${i})
+			string(JSON attribute GET "${json}" attributes ${member})
+			member_key(key "${json}" attributes ${i})
+			set(rawKey "${key}")
+
+			json_get(name "${attribute}" name "")
+			symbol_ref(key "${key}")
+			add_symbol("${name}")
+			json_bool(required "${attribute}" required)
+			json_get(type "${attribute}" type STRING)
+			json_get(default "${attribute}" default_value "")
+			json_get(hover "${attribute}" hover_info "")
+			json_get(detail "${attribute}" completion_detail "")
+			value_range(range "${attribute}")
+			add_strings(enumValues "${attribute}" enum_values)
+			add_strings(examples "${attribute}" examples)
+
+			set(hasDefault "true")
+			if (default STREQUAL "")
+				set(hasDefault "false")
+			endif()
+
+			cpp_string(name "${name}")
+			cpp_string(default "${default}")
+			cpp_string(hover "${hover}")
+			cpp_string(detail "${detail}")
+
+			add_record(index attributes "{ ${key}, ${name}, ${required}, ValueType::${type}, ${hasDefault}, ${default}, ${range}, ${enumValues}, ${hover}, ${detail}, ${examples} }")
+			set_property(GLOBAL PROPERTY attribute_${index}_key "${rawKey}")
+			list(APPEND indices ${index})
+		endforeach()
+	endif()
+	set(${out} "${indices}" PARENT_SCOPE)
+endfunction()
+
+# Children of ${json}, appended to tags with everything below them, their indices in ${out}
+function(add_children out json)
+	set(indices "")
+	json_length(count "${json}" children)
+	if (count GREATER 0)
+		math(EXPR last "${count} - 1")
+		foreach (i RANGE ${last})
+			string(JSON member MEMBER "${json}" children ${i})
+			string(JSON child GET "${json}" children ${member})
+			member_key(key "${json}" children ${i})
+			add_tag(index "${child}" "${key}")
+			list(APPEND indices ${index})
+		endforeach()
+	endif()
+	set(${out} "${indices}" PARENT_SCOPE)
+endfunction()
+
+# Appends the tag record of ${fields} (key to allow_multiple) with its
+# lists, stored under ${key} in its parent; its index in ${out}
+function(add_tag_record out key fields attributes children variants condition)
+	sorted_by_key(attributes attribute ${attributes})
+	add_attribute_list(attributeRange "${attributes}")
+	add_tag_list(childRange "${children}")
+
+	add_record(index tags "{ ${fields}, ${attributeRange}, ${childRange}, ${variants}, ${condition} }")
+	set_property(GLOBAL PROPERTY tag_${index}_key "${key}")
+	set_property(GLOBAL PROPERTY tag_${index}_children "${children}")
+	set_property(GLOBAL PROPERTY tag_${index}_attributes "${attributes}")
+	set(${out} ${index} PARENT_SCOPE)
+endfunction()
+
+# Range of the variants of ${json}, appended to variants once everything
+# below them is, each with the tag record it makes once merged into the tag
+# ${key}: the attributes and children of the variant added to those of the
+# tag, ${attributes} and ${children}, its text if it allows one, its range
+# and enum values, and the ${head} and ${tail} fields of the tag.
+function(add_variants out json key head text tail attributes children)
+	json_length(count "${json}" variants)
+	if (count EQUAL 0)
+		set(${out} "{ 0, 0 }" PARENT_SCOPE)
+		return()
+	endif()
+
+	math(EXPR last "${count} - 1")
+	foreach (i RANGE ${last})
+		string(JSON variant GET "${json}" variants ${i})
+
+		json_get(attr "${variant}" discriminator_attr "")
+		symbol_ref(attr_${i} "${attr}")
+		json_get(value "${variant}" discriminator_value "")
+		json_get(hover "${variant}" hover_info "")
+		cpp_string(value_${i} "${value}")
+		cpp_string(hover_${i} "${hover}")
+
+		set(text_${i} "${text}")
+		json_get(allowText "${variant}" allow_text OFF)
+		if (allowText)
+			text_type(textType "${variant}")
+			set(text_${i} "true, ${textType}")
+		endif()
+		value_range(range_${i} "${variant}")
+		add_strings(enumValues_${i} "${variant}" enum_values)
+
+		add_attributes(variantAttributes "${variant}")
+		add_children(variantChildren "${variant}")
+		json_strings(includes "${variant}" include)
+		group_tags(includedTags ${includes})
+
+		set(attributes_${i} ${attributes} ${variantAttributes})
+		sorted_by_key(children_${i} tag ${children} ${variantChildren} ${includedTags})
+	endforeach()
+
+	table_size(begin variants)
+	set(records "")
+	foreach (i RANGE ${last})
+		math(EXPR condition "${begin} + ${i}")
+		add_tag_record(tag "${key}" "${head}, ${text_${i}}, ${range_${i}}, ${enumValues_${i}}, ${tail}"
+			"${attributes_${i}}" "${children_${i}}" "{ 0, 0 }" ${condition})
+		string(APPEND records "\t{ ${attr_${i}}, ${value_${i}}, ${hover_${i}}, ${tag} },\n")
+	endforeach()
+
+	add_records(variants "${records}" ${count})
+	set(${out} "{ ${begin}, ${count} }" PARENT_SCOPE)
+endfunction()
+
+# Appends the tag ${json}, stored under ${key} in its parent, and everything below it; its index in ${out}
+function(add_tag out json key)
+	json_get(name "${json}" name "")
+	json_bool(required "${json}" required)
+	json_bool(allowText "${json}" allow_text)
+	json_bool(allowMultiple "${json}" allow_multiple)
+	json_get(hover "${json}" hover_info "")
+	json_get(detail "${json}" completion_detail "")
+	text_type(textType "${json}")
+	value_range(range "${json}")
+	add_strings(enumValues "${json}" enum_values)
+	add_strings(examples "${json}" examples)
+	add_attributes(attributes "${json}")
+	add_children(children "${json}")
+	json_strings(includes "${json}" include)
+	group_tags(includedTags ${includes})
+	sorted_by_key(children tag ${children} ${includedTags})
+	symbol_ref(keySymbol "${key}")
+	add_symbol("${name}")
+
+	cpp_string(name "${name}")
+	cpp_string(hover "${hover}")
+	cpp_string(detail "${detail}")
+
+	set(head "${keySymbol}, ${name}, ${required}")
+	set(tail "${hover}, ${detail}, ${examples}, ${allowMultiple}")
+	add_variants(variants "${json}" "${key}" "${head}" "${allowText}, ${textType}" "${tail}" "${attributes}" "${children}")
+	add_tag_record(index "${key}" "${head}, ${allowText}, ${textType}, ${range}, ${enumValues}, ${tail}"
+		"${attributes}" "${children}" "${variants}" noRecord)
+	set(${out} ${index} PARENT_SCOPE)
+endfunction()
+
+# FNV-1a of the two bytes of ${owner} then of the four of the symbol ID ${key}, as schema::hashKey()
+function(hash_key out owner key)
+	set(bytes "")
+	foreach (shift 0 8)
+		math(EXPR byte "(${owner} >> ${shift}) & 255")
+		list(APPEND bytes ${byte})
+	endforeach()
+	foreach (shift 0 8 16 24)
+		math(EXPR byte "(${key} >> ${shift}) & 255")
+		list(APPEND bytes ${byte})
+	endforeach()
+
+	set(hash 2166136261)
+	foreach (byte IN LISTS bytes)
+		math(EXPR hash "((${hash} ^ ${byte}) * 16777619) & 0xFFFFFFFF")
+	endforeach()
+	set(${out} ${hash} PARENT_SCOPE)
+endfunction()
+
+# Slot of ${hash} displaced by ${seed} in a table of ${size} slots, as schema::slotOf()
+function(slot_of out hash seed size)
+	math(EXPR mixed "((${hash} ^ ${seed}) * 73244475) & 0xFFFFFFFF")
+	math(EXPR mixed "(${mixed} ^ (${mixed} >> 16)) & (${size} - 1)")
+	set(${out} ${mixed} PARENT_SCOPE)
+endfunction()
+
+# Adds the key ${name} of ${owner}, looked up to ${record}, to the perfect hash ${table}
+function(add_hash_key table owner name record)
+	get_property(key GLOBAL PROPERTY symbol_${name}_id)
+	hash_key(hash ${owner} ${key})
+	set_property(GLOBAL APPEND PROPERTY ${table}_hashes ${hash})
+	set_property(GLOBAL APPEND PROPERTY ${table}_slots "{ ${owner}, ${record} }")
+endfunction()
+
+# Hash and displace: keys go to buckets by the low bits of their hash, then
+# each bucket, largest first, gets the first seed sending all its keys to
+# free slots. Twice as many slots as keys, and half as many buckets.
+function(perfect_hash_source out table)
+	get_property(hashes GLOBAL PROPERTY ${table}_hashes)
+	get_property(entries GLOBAL PROPERTY ${table}_slots)
+	list(LENGTH hashes count)
+
+	set(size 2)
+	math(EXPR wanted "${count} * 2")
+	while (size LESS wanted)
+		math(EXPR size "${size} * 2")
+	endwhile()
+	math(EXPR bucketCount "${size} / 2")
+	math(EXPR lastBucket "${bucketCount} - 1")
+	math(EXPR lastSlot "${size} - 1")
+
+	set(largest 0)
+	foreach (b RANGE ${lastBucket})
+		set(bucket_${b} "")
+	endforeach()
+	if (count GREATER 0)
+		math(EXPR lastKey "${count} - 1")
+		foreach (k RANGE ${lastKey})
+			list(GET hashes ${k} hash)
+			math(EXPR b "${hash} & ${lastBucket}")
+			list(APPEND bucket_${b} ${k})
+			list(LENGTH bucket_${b} length)
+			if (length GREATER largest)
+				set(largest ${length})
+			endif()
+		endforeach()
+	endif()
+
+	foreach (s RANGE ${lastSlot})
+		set(slot_${s} "")
+	endforeach()
+	foreach (b RANGE ${lastBucket})
+		set(seed_${b} 0)
+	endforeach()
+
+	set(length ${largest})
+	while (length GREATER 0)
+		foreach (b RANGE ${lastBucket})
+			list(LENGTH bucket_${b} bucketLength)
+			if (NOT bucketLength EQUAL length)
+				continue()
+			endif()
+
+			set(seed 0)
+			while (TRUE)
+				set(taken "")
+				set(fits TRUE)
+				foreach (k IN LISTS bucket_${b})
+					list(GET hashes ${k} hash)
+					slot_of(slot ${hash} ${seed} ${size})
+					list(FIND taken ${slot} found)
+					if (NOT "${slot_${slot}}" STREQUAL "" OR found GREATER -1)
+						set(fits FALSE)
+						break()
+					endif()
+					list(APPEND taken ${slot})
+				endforeach()
+				if (fits)
+					break()
+				endif()
+				math(EXPR seed "${seed} + 1")
+				if (seed GREATER 100000)
+					message(FATAL_ERROR "No perfect hash seed found for ${table}")
+				endif()
+			endwhile()
+
+			set(seed_${b} ${seed})
+			foreach (k IN LISTS bucket_${b})
+				list(GET hashes ${k} hash)
+				slot_of(slot ${hash} ${seed} ${size})
+				list(GET entries ${k} slot_${slot})
+			endforeach()
+		endforeach()
+		math(EXPR length "${length} - 1")
+	endwhile()
+
+	set(seeds "")
+	foreach (b RANGE ${lastBucket})
+		string(APPEND seeds "\t${seed_${b}}u,\n")
+	endforeach()
+	set(slots "")
+	foreach (s RANGE ${lastSlot})
+		if ("${slot_${s}}" STREQUAL "")
+			string(APPEND slots "\t{ 0, noRecord },\n")
+		else()
+			string(APPEND slots "\t${slot_${s}},\n")
+		endif()
+	endforeach()
+
+	set(${out} "inline constexpr std::array<uint32_t, ${bucketCount}> ${table}Seeds = {{\n${seeds}}};\n\ninline constexpr std::array<HashSlot, ${size}> ${table}Slots = {{\n${slots}}};\n" PARENT_SCOPE)
+endfunction()
+
+# constexpr array of the records of ${table}
+function(table_source out table type)
+	table_size(count ${table})
+	get_property(records GLOBAL PROPERTY ${table}_records)
+	set(${out} "inline constexpr std::array<${type}, ${count}> ${table} = {{\n${records}}};\n" PARENT_SCOPE)
+endfunction()
+
+# X macros of the symbols, sorted: TDR_KNOWN_SYMBOLS gets every name that is
+# a C++ identifier, and root, TDR_OTHER_SYMBOLS the others as string literals.
+# Interned in this order after the empty name, each gets its ID as the
+# symbol_${name}_id property, and the others their constant as symbol_${name}_ref.
+function(symbols_source out)
+	get_property(names GLOBAL PROPERTY symbol_names)
+	list(APPEND names root)
+	list(REMOVE_DUPLICATES names)
+	list(SORT names)
+
+	set(known "")
+	set(others "")
+	set(otherNames "")
+	foreach (name IN LISTS names)
+		is_identifier(identifier "${name}")
+		if (identifier)
+			list(APPEND known "X(${name})")
+			list(LENGTH known id)
+			set_property(GLOBAL PROPERTY symbol_${name}_id ${id})
+		else()
+			cpp_string(literal "${name}")
+			list(APPEND others "X(${literal})")
+			list(APPEND otherNames "${name}")
+		endif()
+	endforeach()
+
+	list(LENGTH known knownCount)
+	set(index 0)
+	foreach (name IN LISTS otherNames)
+		math(EXPR id "${knownCount} + 1 + ${index}")
+		set_property(GLOBAL PROPERTY symbol_${name}_id ${id})
+		set_property(GLOBAL PROPERTY symbol_${name}_ref "sym::Known(sym::KNOWN_COUNT + ${index})")
+		math(EXPR index "${index} + 1")
+	endforeach()
+	set_property(GLOBAL PROPERTY symbol__id 0)
+
+	x_macro(known TDR_KNOWN_SYMBOLS "${known}")
+	x_macro(others TDR_OTHER_SYMBOLS "${others}")
+	set(${out} "${known}\n${others}" PARENT_SCOPE)
+endfunction()
+
+# ${source} with the placeholders of symbol_ref() replaced by their constants
+function(resolve_symbols out source)
+	get_property(refs GLOBAL PROPERTY symbol_refs)
+	set(ref 0)
+	foreach (name IN LISTS refs)
+		get_property(constant GLOBAL PROPERTY symbol_${name}_ref)
+		string(REPLACE "@symbol_${ref}@" "${constant}" source "${source}")
+		math(EXPR ref "${ref} + 1")
+	endforeach()
+	set(${out} "${source}" PARENT_SCOPE)
+endfunction()
+
+# Definition of the macro ${name} expanding to ${entries}, wrapped at 100 columns
+function(x_macro out name entries)
+	set(lines "")
+	set(line "\t")
+	foreach (entry IN LISTS entries)
+		string(LENGTH "${line}${entry} " length)
+		if (length GREATER 100)
+			string(REGEX REPLACE " +$" "" line "${line}")
+			string(APPEND lines " \\\n${line}")
+			set(line "\t")
+		endif()
+		string(APPEND line "${entry} ")
+	endforeach()
+	string(REGEX REPLACE " +$" "" line "${line}")
+	if (NOT line STREQUAL "\t")
+		string(APPEND lines " \\\n${line}")
+	endif()
+	set(${out} "#define ${name}(X)${lines}\n" PARENT_SCOPE)
+endfunction()
+
+if (NOT INPUT OR NOT OUTPUT OR NOT SYMBOLS)
+	message(FATAL_ERROR "Usage: cmake -DINPUT=schema.json -DOUTPUT=schemaData.hpp -DSYMBOLS=schemaSymbols.hpp -P generateSchema.cmake")
+endif()
+
+file(READ "${INPUT}" schema)
+
+# Tag groups, before the tags including them
+json_length(groupCount "${schema}" tag_groups)
+if (groupCount GREATER 0)
+	math(EXPR last "${groupCount} - 1")
+	foreach (g RANGE ${last})
+		string(JSON groupName MEMBER "${schema}" tag_groups ${g})
+		string(JSON group GET "${schema}" tag_groups ${groupName})
+
+		set(indices "")
+		string(JSON count LENGTH "${group}")
+		if (count GREATER 0)
+			math(EXPR lastTag "${count} - 1")
+			foreach (i RANGE ${lastTag})
+				string(JSON tagName MEMBER "${group}" ${i})
+				string(JSON tag GET "${group}" ${tagName})
+				add_tag(index "${tag}" "${tagName}")
+				list(APPEND indices ${index})
+			endforeach()
+		endif()
+		set_property(GLOBAL PROPERTY group_${groupName}_tags "${indices}")
+	endforeach()
+endif()
+
+# Top level tags, children of the root record
+set(indices "")
+json_length(count "${schema}" tags)
+if (count GREATER 0)
+	math(EXPR last "${count} - 1")
+	foreach (i RANGE ${last})
+		string(JSON member MEMBER "${schema}" tags ${i})
+		string(JSON tag GET "${schema}" tags ${member})
+		member_key(key "${schema}" tags ${i})
+		add_tag(index "${tag}" "${key}")
+		list(APPEND indices ${index})
+	endforeach()
+endif()
+sorted_by_key(indices tag ${indices})
+symbol_ref(rootSymbol root)
+add_tag_record(rootTag root "${rootSymbol}, \"\", false, false, false, ValueType::STRING, false, 0.0f, 0.0f, { 0, 0 }, \"\", \"\", { 0, 0 }, false"
+	"" "${indices}" "{ 0, 0 }" noRecord)
+
+# Every name is known now: symbol IDs for the hashes, constants for the records
+symbols_source(knownSymbols)
+
+# Lookup of the children and attributes of each tag
+table_size(tagCount tags)
+math(EXPR last "${tagCount} - 1")
+foreach (t RANGE ${last})
+	get_property(children GLOBAL PROPERTY tag_${t}_children)
+	foreach (c IN LISTS children)
+		get_property(key GLOBAL PROPERTY tag_${c}_key)
+		add_hash_key(childLookup ${t} "${key}" ${c})
+	endforeach()
+
+	get_property(tagAttributes GLOBAL PROPERTY tag_${t}_attributes)
+	foreach (a IN LISTS tagAttributes)
+		get_property(key GLOBAL PROPERTY attribute_${a}_key)
+		add_hash_key(attributeLookup ${t} "${key}" ${a})
+	endforeach()
+endforeach()
+perfect_hash_source(childLookup childLookup)
+perfect_hash_source(attributeLookup attributeLookup)
+
+table_source(strings strings std::string_view)
+table_source(attributes attributes AttributeSchema)
+table_source(tags tags TagSchema)
+table_source(variants variants ConditionalVariant)
+table_source(tagLists tagLists uint16_t)
+table_source(attributeLists attributeLists uint16_t)
+
+set(source "// Generated from schema.json by cmake/generateSchema.cmake, do not edit\n\n")
+string(APPEND source "#pragma once\n\n#include \"tdr/schemaTables.hpp\"\n\nnamespace sceneIO::tdr::schema {\n\n")
+string(APPEND source "${strings}\n${attributes}\n${tags}\n${variants}\n${tagLists}\n${attributeLists}\n${childLookup}\n${attributeLookup}\n")
+string(APPEND source "inline constexpr uint16_t rootTag = ${rootTag};\n\n}\n")
+resolve_symbols(source "${source}")
+
+file(WRITE "${OUTPUT}" "${source}")
+
+set(source "// Generated from schema.json by cmake/generateSchema.cmake, do not edit\n\n")
+string(APPEND source "#pragma once\n\n${knownSymbols}")
+
+file(WRITE "${SYMBOLS}" "${source}")
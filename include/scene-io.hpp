@@ -1,4 +1,6 @@
 #pragma once
 
 #include "objParser.hpp"
+#include "gltfParser.hpp"
+#include "objWriter.hpp"
 #include "tdr/loadScene.hpp"
@@ -0,0 +1,809 @@
+#include "gltfParser.hpp"
+#include "mappedFile.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace sceneIO::parser
+{
+	namespace
+	{
+		constexpr uint32_t GLB_MAGIC      = 0x46546C67; // "glTF"
+		constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+		constexpr uint32_t GLB_CHUNK_BIN  = 0x004E4942; // "BIN\0"
+
+		constexpr int COMPONENT_BYTE           = 5120;
+		constexpr int COMPONENT_UNSIGNED_BYTE  = 5121;
+		constexpr int COMPONENT_SHORT          = 5122;
+		constexpr int COMPONENT_UNSIGNED_SHORT = 5123;
+		constexpr int COMPONENT_UNSIGNED_INT   = 5125;
+		constexpr int COMPONENT_FLOAT          = 5126;
+
+		constexpr int MODE_TRIANGLES = 4;
+
+		/**
+		 * Minimal JSON document model, enough for the glTF header chunk.
+		 */
+		struct JsonValue
+		{
+			enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+			Type type = Type::NUL;
+			bool boolean = false;
+			double number = 0.0;
+			std::string string;
+			std::vector<JsonValue> array;
+			std::vector<std::pair<std::string, JsonValue>> object;
+
+			const JsonValue *find(std::string_view key) const
+			{
+				if (type != Type::OBJECT) return nullptr;
+				for (const auto& [name, value] : object)
+					if (name == key) return &value;
+				return nullptr;
+			}
+
+			const JsonValue *at(size_t index) const
+			{
+				if (type != Type::ARRAY || index >= array.size()) return nullptr;
+				return &array[index];
+			}
+
+			int64_t getInt(std::string_view key, int64_t fallback) const
+			{
+				const JsonValue *v = find(key);
+				return (v && v->type == Type::NUMBER) ? static_cast<int64_t>(v->number) : fallback;
+			}
+
+			std::string getString(std::string_view key, const std::string& fallback) const
+			{
+				const JsonValue *v = find(key);
+				return (v && v->type == Type::STRING) ? v->string : fallback;
+			}
+		};
+
+		class JsonReader
+		{
+		public:
+			explicit JsonReader(std::string_view src) : src_(src) {}
+
+			JsonValue parse()
+			{
+				JsonValue res = parseValue(0);
+				skipWhitespace();
+				// The JSON chunk is padded with spaces, anything else is garbage
+				if (pos_ != src_.size()) fail("Trailing characters after JSON document");
+				return res;
+			}
+
+		private:
+			static constexpr int MAX_DEPTH = 256;
+
+			std::string_view src_;
+			size_t pos_ = 0;
+
+			[[noreturn]] void fail(const std::string& msg) const
+			{
+				throw std::runtime_error("Invalid glTF JSON chunk at byte " + std::to_string(pos_) + ": " + msg);
+			}
+
+			void skipWhitespace()
+			{
+				while (pos_ < src_.size() && (src_[pos_] == ' ' || src_[pos_] == '\t' || src_[pos_] == '\n' || src_[pos_] == '\r'))
+					pos_++;
+			}
+
+			char peek() const { return pos_ < src_.size() ? src_[pos_] : '\0'; }
+
+			void expect(char c)
+			{
+				if (peek() != c) fail(std::string("expected '") + c + "'");
+				pos_++;
+			}
+
+			bool consumeLiteral(std::string_view lit)
+			{
+				if (src_.substr(pos_, lit.size()) != lit) return false;
+				pos_ += lit.size();
+				return true;
+			}
+
+			static void appendUtf8(std::string& out, uint32_t cp)
+			{
+				if (cp < 0x80) out += static_cast<char>(cp);
+				else if (cp < 0x800)
+				{
+					out += static_cast<char>(0xC0 | (cp >> 6));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+				else if (cp < 0x10000)
+				{
+					out += static_cast<char>(0xE0 | (cp >> 12));
+					out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+				else
+				{
+					out += static_cast<char>(0xF0 | (cp >> 18));
+					out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+					out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (cp & 0x3F));
+				}
+			}
+
+			uint32_t parseHex4()
+			{
+				if (pos_ + 4 > src_.size()) fail("truncated unicode escape");
+				uint32_t cp = 0;
+				auto [ptr, ec] = std::from_chars(src_.data() + pos_, src_.data() + pos_ + 4, cp, 16);
+				if (ec != std::errc() || ptr != src_.data() + pos_ + 4) fail("invalid unicode escape");
+				pos_ += 4;
+				return cp;
+			}
+
+			std::string parseString()
+			{
+				expect('"');
+				std::string out;
+
+				while (true)
+				{
+					if (pos_ >= src_.size()) fail("unterminated string");
+					char c = src_[pos_++];
+
+					if (c == '"') break;
+					if (c != '\\')
+					{
+						out += c;
+						continue;
+					}
+
+					if (pos_ >= src_.size()) fail("unterminated escape sequence");
+					c = src_[pos_++];
+					switch (c)
+					{
+						case '"':	out += '"';		break;
+						case '\\':	out += '\\';	break;
+						case '/':	out += '/';		break;
+						case 'b':	out += '\b';	break;
+						case 'f':	out += '\f';	break;
+						case 'n':	out += '\n';	break;
+						case 'r':	out += '\r';	break;
+						case 't':	out += '\t';	break;
+						case 'u':
+						{
+							uint32_t cp = parseHex4();
+							if (cp >= 0xD800 && cp <= 0xDBFF && consumeLiteral("\\u"))
+							{
+								uint32_t low = parseHex4();
+								cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+							}
+							appendUtf8(out, cp);
+							break;
+						}
+						default: fail("invalid escape sequence");
+					}
+				}
+				return out;
+			}
+
+			double parseNumber()
+			{
+				double value = 0.0;
+				auto [ptr, ec] = std::from_chars(src_.data() + pos_, src_.data() + src_.size(), value);
+				if (ec != std::errc()) fail("invalid number");
+				pos_ = static_cast<size_t>(ptr - src_.data());
+				return value;
+			}
+
+			JsonValue parseValue(int depth)
+			{
+				if (depth > MAX_DEPTH) fail("document nested too deeply");
+
+				skipWhitespace();
+				JsonValue res;
+
+				char c = peek();
+				if (c == '{')
+				{
+					res.type = JsonValue::Type::OBJECT;
+					pos_++;
+					skipWhitespace();
+					if (peek() == '}') { pos_++; return res; }
+
+					while (true)
+					{
+						skipWhitespace();
+						std::string key = parseString();
+						skipWhitespace();
+						expect(':');
+						res.object.emplace_back(std::move(key), parseValue(depth + 1));
+						skipWhitespace();
+						if (peek() == ',') { pos_++; continue; }
+						expect('}');
+						break;
+					}
+				}
+				else if (c == '[')
+				{
+					res.type = JsonValue::Type::ARRAY;
+					pos_++;
+					skipWhitespace();
+					if (peek() == ']') { pos_++; return res; }
+
+					while (true)
+					{
+						res.array.push_back(parseValue(depth + 1));
+						skipWhitespace();
+						if (peek() == ',') { pos_++; continue; }
+						expect(']');
+						break;
+					}
+				}
+				else if (c == '"')
+				{
+					res.type = JsonValue::Type::STRING;
+					res.string = parseString();
+				}
+				else if (consumeLiteral("true"))
+				{
+					res.type = JsonValue::Type::BOOL;
+					res.boolean = true;
+				}
+				else if (consumeLiteral("false"))
+				{
+					res.type = JsonValue::Type::BOOL;
+				}
+				else if (consumeLiteral("null"))
+				{
+					res.type = JsonValue::Type::NUL;
+				}
+				else
+				{
+					res.type = JsonValue::Type::NUMBER;
+					res.number = parseNumber();
+				}
+				return res;
+			}
+		};
+
+		/**
+		 * Resolved accessor: a strided view into the BIN chunk.
+		 */
+		struct AccessorView
+		{
+			const uint8_t *data = nullptr;
+			size_t count = 0;
+			size_t stride = 0;
+			int componentType = 0;
+			int components = 0;
+			bool normalized = false;
+		};
+
+		size_t componentSize(int componentType)
+		{
+			switch (componentType)
+			{
+				case COMPONENT_BYTE:
+				case COMPONENT_UNSIGNED_BYTE:	return 1;
+				case COMPONENT_SHORT:
+				case COMPONENT_UNSIGNED_SHORT:	return 2;
+				case COMPONENT_UNSIGNED_INT:
+				case COMPONENT_FLOAT:			return 4;
+				default: break;
+			}
+			return 0;
+		}
+
+		int componentCount(const std::string& type)
+		{
+			if (type == "SCALAR") return 1;
+			if (type == "VEC2") return 2;
+			if (type == "VEC3") return 3;
+			if (type == "VEC4") return 4;
+			return 0;
+		}
+
+		template <typename T>
+		T loadUnaligned(const uint8_t *p)
+		{
+			T v;
+			std::memcpy(&v, p, sizeof(T));
+			return v;
+		}
+
+		float readComponent(const uint8_t *p, int componentType, bool normalized)
+		{
+			switch (componentType)
+			{
+				case COMPONENT_FLOAT: return loadUnaligned<float>(p);
+				case COMPONENT_BYTE:
+				{
+					float v = static_cast<float>(loadUnaligned<int8_t>(p));
+					return normalized ? std::max(v / 127.0f, -1.0f) : v;
+				}
+				case COMPONENT_UNSIGNED_BYTE:
+				{
+					float v = static_cast<float>(loadUnaligned<uint8_t>(p));
+					return normalized ? v / 255.0f : v;
+				}
+				case COMPONENT_SHORT:
+				{
+					float v = static_cast<float>(loadUnaligned<int16_t>(p));
+					return normalized ? std::max(v / 32767.0f, -1.0f) : v;
+				}
+				case COMPONENT_UNSIGNED_SHORT:
+				{
+					float v = static_cast<float>(loadUnaligned<uint16_t>(p));
+					return normalized ? v / 65535.0f : v;
+				}
+				case COMPONENT_UNSIGNED_INT: return static_cast<float>(loadUnaligned<uint32_t>(p));
+				default: break;
+			}
+			return 0.0f;
+		}
+
+		uint32_t readIndex(const uint8_t *p, int componentType)
+		{
+			switch (componentType)
+			{
+				case COMPONENT_UNSIGNED_BYTE:	return loadUnaligned<uint8_t>(p);
+				case COMPONENT_UNSIGNED_SHORT:	return loadUnaligned<uint16_t>(p);
+				case COMPONENT_UNSIGNED_INT:	return loadUnaligned<uint32_t>(p);
+				default: break;
+			}
+			return 0;
+		}
+
+		class GlbReader
+		{
+		public:
+			GlbReader(const JsonValue& doc, const uint8_t *bin, size_t binSize, ObjErrorCollector& errors)
+				: doc_(doc), bin_(bin), binSize_(binSize), errors_(errors) {}
+
+			void read(Asset::ObjectData& objAsset)
+			{
+				const JsonValue *meshes = doc_.find("meshes");
+				if (!meshes || meshes->type != JsonValue::Type::ARRAY) return;
+
+				for (size_t meshIndex = 0; meshIndex < meshes->array.size(); meshIndex++)
+				{
+					const JsonValue& meshJson = meshes->array[meshIndex];
+					auto mesh = std::make_unique<Mesh>(meshJson.getString("name", "Default"));
+
+					const JsonValue *primitives = meshJson.find("primitives");
+					if (primitives && primitives->type == JsonValue::Type::ARRAY)
+					{
+						for (size_t primIndex = 0; primIndex < primitives->array.size(); primIndex++)
+							readPrimitive(*mesh, primitives->array[primIndex], meshIndex, primIndex);
+					}
+
+					objAsset.meshes.push_back(std::move(mesh));
+				}
+			}
+
+		private:
+			const JsonValue& doc_;
+			const uint8_t *bin_;
+			size_t binSize_;
+			ObjErrorCollector& errors_;
+
+			std::string where(size_t meshIndex, size_t primIndex) const
+			{
+				return "mesh " + std::to_string(meshIndex) + ", primitive " + std::to_string(primIndex) + ": ";
+			}
+
+			std::string materialName(int64_t index) const
+			{
+				if (index < 0) return "default";
+
+				const JsonValue *materials = doc_.find("materials");
+				const JsonValue *material = materials ? materials->at(static_cast<size_t>(index)) : nullptr;
+				if (!material) return "default";
+
+				return material->getString("name", "material_" + std::to_string(index));
+			}
+
+			/**
+			 * @return false if the accessor is missing or does not fit in its buffer view
+			 *         (error reported to the collector).
+			 */
+			bool resolveAccessor(int64_t index, AccessorView& out, const std::string& ctx)
+			{
+				const JsonValue *accessors = doc_.find("accessors");
+				const JsonValue *accessor = (accessors && index >= 0) ? accessors->at(static_cast<size_t>(index)) : nullptr;
+				if (!accessor)
+				{
+					errors_.report(ctx + "invalid accessor index " + std::to_string(index));
+					return false;
+				}
+
+				out.componentType = static_cast<int>(accessor->getInt("componentType", 0));
+				out.components = componentCount(accessor->getString("type", ""));
+				out.count = static_cast<size_t>(std::max<int64_t>(accessor->getInt("count", 0), 0));
+
+				const JsonValue *normalized = accessor->find("normalized");
+				out.normalized = normalized && normalized->type == JsonValue::Type::BOOL && normalized->boolean;
+
+				size_t elementSize = componentSize(out.componentType) * static_cast<size_t>(out.components);
+				if (elementSize == 0)
+				{
+					errors_.report(ctx + "unsupported accessor layout");
+					return false;
+				}
+
+				if (accessor->find("sparse"))
+				{
+					errors_.report(ctx + "sparse accessors are not supported");
+					return false;
+				}
+
+				const JsonValue *bufferViews = doc_.find("bufferViews");
+				int64_t viewIndex = accessor->getInt("bufferView", -1);
+				const JsonValue *view = (bufferViews && viewIndex >= 0) ? bufferViews->at(static_cast<size_t>(viewIndex)) : nullptr;
+				if (!view)
+				{
+					errors_.report(ctx + "accessor without buffer view is not supported");
+					return false;
+				}
+
+				if (view->getInt("buffer", 0) != 0)
+				{
+					errors_.report(ctx + "only the embedded GLB buffer is supported");
+					return false;
+				}
+
+				size_t viewOffset = static_cast<size_t>(std::max<int64_t>(view->getInt("byteOffset", 0), 0));
+				size_t viewLength = static_cast<size_t>(std::max<int64_t>(view->getInt("byteLength", 0), 0));
+				size_t accessorOffset = static_cast<size_t>(std::max<int64_t>(accessor->getInt("byteOffset", 0), 0));
+				out.stride = static_cast<size_t>(std::max<int64_t>(view->getInt("byteStride", 0), 0));
+				if (out.stride == 0) out.stride = elementSize;
+
+				if (viewOffset > binSize_ || viewLength > binSize_ - viewOffset)
+				{
+					errors_.report(ctx + "buffer view out of the BIN chunk");
+					return false;
+				}
+
+				if (out.count > 0 && (accessorOffset > viewLength || elementSize > viewLength - accessorOffset
+					|| (out.count - 1) > (viewLength - accessorOffset - elementSize) / out.stride))
+				{
+					errors_.report(ctx + "accessor out of its buffer view");
+					return false;
+				}
+
+				out.data = bin_ + viewOffset + accessorOffset;
+				return true;
+			}
+
+			/**
+			 * Copies the attributes into @p vertices, starting at @p base.
+			 * When the three attributes already sit in one buffer view with the
+			 * exact layout of Vertex the whole block is copied in one go.
+			 */
+			void readVertices(std::vector<Vertex>& vertices, size_t base,
+			                  const AccessorView& pos, const AccessorView *normal, const AccessorView *uv)
+			{
+				static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex must be trivially copyable");
+
+				// Offsets are compared relative to the BIN chunk so no pointer outside it is ever formed
+				size_t posOffset = static_cast<size_t>(pos.data - bin_);
+				size_t blockOffset = posOffset - offsetof(Vertex, pos);
+
+				bool packed = normal && uv
+					&& pos.componentType == COMPONENT_FLOAT && normal->componentType == COMPONENT_FLOAT && uv->componentType == COMPONENT_FLOAT
+					&& pos.components == 3 && normal->components == 3 && uv->components == 2
+					&& pos.stride == sizeof(Vertex) && normal->stride == sizeof(Vertex) && uv->stride == sizeof(Vertex)
+					&& normal->count == pos.count && uv->count == pos.count
+					&& posOffset >= offsetof(Vertex, pos)
+					&& pos.count <= (binSize_ - blockOffset) / sizeof(Vertex)
+					&& static_cast<size_t>(normal->data - bin_) == blockOffset + offsetof(Vertex, normal)
+					&& static_cast<size_t>(uv->data - bin_) == blockOffset + offsetof(Vertex, uv);
+
+				if (packed)
+				{
+					const uint8_t *block = bin_ + blockOffset;
+					std::memcpy(vertices.data() + base, block, pos.count * sizeof(Vertex));
+					return;
+				}
+
+				auto readVec3 = [](const AccessorView& acc, size_t i) -> vec3
+				{
+					const uint8_t *p = acc.data + i * acc.stride;
+					if (acc.componentType == COMPONENT_FLOAT)
+					{
+						vec3 v;
+						std::memcpy(&v.x, p, sizeof(float));
+						std::memcpy(&v.y, p + 4, sizeof(float));
+						std::memcpy(&v.z, p + 8, sizeof(float));
+						return v;
+					}
+					size_t cs = componentSize(acc.componentType);
+					return vec3(readComponent(p, acc.componentType, acc.normalized),
+					            readComponent(p + cs, acc.componentType, acc.normalized),
+					            readComponent(p + 2 * cs, acc.componentType, acc.normalized));
+				};
+
+				for (size_t i = 0; i < pos.count; i++)
+				{
+					Vertex& v = vertices[base + i];
+
+					v.pos = readVec3(pos, i);
+					v.normal = (normal && i < normal->count) ? readVec3(*normal, i) : vec3(0);
+
+					if (uv && i < uv->count)
+					{
+						const uint8_t *p = uv->data + i * uv->stride;
+						size_t cs = componentSize(uv->componentType);
+						v.uv = vec2(readComponent(p, uv->componentType, uv->normalized),
+						            readComponent(p + cs, uv->componentType, uv->normalized));
+					}
+					else v.uv = vec2(0);
+				}
+			}
+
+			/**
+			 * @return false on an out of range index (error reported).
+			 */
+			bool readIndices(std::vector<uint32_t>& indices, const AccessorView& acc,
+			                 uint32_t baseVertex, uint32_t vertexCount, const std::string& ctx)
+			{
+				size_t first = indices.size();
+				indices.resize(first + acc.count);
+				uint32_t *dst = indices.data() + first;
+
+				if (acc.componentType == COMPONENT_UNSIGNED_INT && acc.stride == sizeof(uint32_t))
+				{
+					std::memcpy(dst, acc.data, acc.count * sizeof(uint32_t));
+					uint32_t maxIndex = 0;
+					for (size_t i = 0; i < acc.count; i++)
+						maxIndex = std::max(maxIndex, dst[i]);
+					if (acc.count > 0 && maxIndex >= vertexCount)
+					{
+						errors_.report(ctx + "vertex index out of range");
+						indices.resize(first);
+						return false;
+					}
+					if (baseVertex != 0)
+						for (size_t i = 0; i < acc.count; i++)
+							dst[i] += baseVertex;
+					return true;
+				}
+
+				for (size_t i = 0; i < acc.count; i++)
+				{
+					uint32_t index = readIndex(acc.data + i * acc.stride, acc.componentType);
+					if (index >= vertexCount)
+					{
+						errors_.report(ctx + "vertex index out of range");
+						indices.resize(first);
+						return false;
+					}
+					dst[i] = index + baseVertex;
+				}
+				return true;
+			}
+
+			/**
+			 * glTF leaves the normals to the importer when they are omitted.
+			 * Same policy as the OBJ parser: a vertex without normal takes the
+			 * normal of the first face using it.
+			 */
+			static void fillMissingNormals(std::vector<Vertex>& vertices, const uint32_t *indices, size_t count)
+			{
+				for (size_t i = 0; i + 2 < count; i += 3)
+				{
+					Vertex& a = vertices[indices[i]];
+					Vertex& b = vertices[indices[i + 1]];
+					Vertex& c = vertices[indices[i + 2]];
+
+					vec3 faceNormal = vec3::cross(b.pos - a.pos, c.pos - a.pos).normalized();
+
+					if (a.normal == vec3(0)) a.normal = faceNormal;
+					if (b.normal == vec3(0)) b.normal = faceNormal;
+					if (c.normal == vec3(0)) c.normal = faceNormal;
+				}
+			}
+
+			void readPrimitive(Mesh& mesh, const JsonValue& prim, size_t meshIndex, size_t primIndex)
+			{
+				std::string ctx = where(meshIndex, primIndex);
+
+				if (prim.getInt("mode", MODE_TRIANGLES) != MODE_TRIANGLES)
+				{
+					errors_.report(ctx + "only triangle primitives are supported");
+					return;
+				}
+
+				const JsonValue *attributes = prim.find("attributes");
+				int64_t posIndex = attributes ? attributes->getInt("POSITION", -1) : -1;
+				if (posIndex < 0)
+				{
+					errors_.report(ctx + "primitive without POSITION attribute");
+					return;
+				}
+
+				AccessorView pos;
+				if (!resolveAccessor(posIndex, pos, ctx)) return;
+				if (pos.components != 3)
+				{
+					errors_.report(ctx + "POSITION must be a VEC3 accessor");
+					return;
+				}
+
+				AccessorView normal, uv;
+				bool hasNormal = false, hasUv = false;
+
+				int64_t normalIndex = attributes->getInt("NORMAL", -1);
+				if (normalIndex >= 0)
+				{
+					if (!resolveAccessor(normalIndex, normal, ctx)) return;
+					hasNormal = normal.components == 3;
+					if (!hasNormal) errors_.report(ctx + "NORMAL must be a VEC3 accessor, normals are computed instead");
+				}
+
+				int64_t uvIndex = attributes->getInt("TEXCOORD_0", -1);
+				if (uvIndex >= 0)
+				{
+					if (!resolveAccessor(uvIndex, uv, ctx)) return;
+					hasUv = uv.components == 2;
+					if (!hasUv) errors_.report(ctx + "TEXCOORD_0 must be a VEC2 accessor, ignored");
+				}
+
+				if (mesh.vertices_.size() + pos.count > UINT32_MAX)
+				{
+					errors_.report(ctx + "too many vertices in mesh");
+					return;
+				}
+
+				uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices_.size());
+				uint32_t vertexCount = static_cast<uint32_t>(pos.count);
+
+				mesh.vertices_.resize(mesh.vertices_.size() + pos.count);
+				readVertices(mesh.vertices_, baseVertex, pos, hasNormal ? &normal : nullptr, hasUv ? &uv : nullptr);
+
+				auto subMesh = std::make_unique<SubMesh>(materialName(prim.getInt("material", -1)));
+
+				int64_t indicesIndex = prim.getInt("indices", -1);
+				if (indicesIndex >= 0)
+				{
+					AccessorView indices;
+					bool valid = resolveAccessor(indicesIndex, indices, ctx);
+
+					if (valid && indices.components != 1)
+					{
+						errors_.report(ctx + "indices must be a SCALAR accessor");
+						valid = false;
+					}
+
+					if (valid && indices.componentType != COMPONENT_UNSIGNED_BYTE && indices.componentType != COMPONENT_UNSIGNED_SHORT
+						&& indices.componentType != COMPONENT_UNSIGNED_INT)
+					{
+						errors_.report(ctx + "indices must be unsigned byte, short or int");
+						valid = false;
+					}
+
+					if (!valid || !readIndices(subMesh->indices_, indices, baseVertex, vertexCount, ctx))
+					{
+						mesh.vertices_.resize(baseVertex);
+						return;
+					}
+				}
+				else
+				{
+					subMesh->indices_.resize(vertexCount);
+					for (uint32_t i = 0; i < vertexCount; i++)
+						subMesh->indices_[i] = baseVertex + i;
+				}
+
+				if (subMesh->indices_.size() % 3 != 0)
+				{
+					errors_.report(ctx + "index count is not a multiple of 3");
+					subMesh->indices_.resize(subMesh->indices_.size() - subMesh->indices_.size() % 3);
+				}
+
+				if (!hasNormal)
+					fillMissingNormals(mesh.vertices_, subMesh->indices_.data(), subMesh->indices_.size());
+
+				mesh.subMeshes_.push_back(std::move(subMesh));
+			}
+		};
+	}
+
+	static void readGlbFile(Asset& asset, const std::string& path, ObjErrorCollector& errors, AssetStats *stats)
+	{
+		MappedFile file;
+		if (!file.open(path))
+		{
+			errors.report("Cannot open file: " + path);
+			return;
+		}
+
+		const uint8_t *data = file.data();
+		size_t size = file.size();
+
+		if (size < 20 || loadUnaligned<uint32_t>(data) != GLB_MAGIC)
+		{
+			errors.report("Not a glTF binary file: " + path);
+			return;
+		}
+
+		if (loadUnaligned<uint32_t>(data + 4) != 2)
+		{
+			errors.report("Unsupported glTF version, only 2.0 is supported: " + path);
+			return;
+		}
+
+		size_t total = std::min<size_t>(loadUnaligned<uint32_t>(data + 8), size);
+
+		std::string_view json;
+		const uint8_t *bin = nullptr;
+		size_t binSize = 0;
+
+		size_t offset = 12;
+		while (offset + 8 <= total)
+		{
+			size_t chunkLength = loadUnaligned<uint32_t>(data + offset);
+			uint32_t chunkType = loadUnaligned<uint32_t>(data + offset + 4);
+			offset += 8;
+
+			if (chunkLength > total - offset)
+			{
+				errors.report("Truncated GLB chunk: " + path);
+				return;
+			}
+
+			if (chunkType == GLB_CHUNK_JSON && json.empty())
+				json = std::string_view(reinterpret_cast<const char *>(data + offset), chunkLength);
+			else if (chunkType == GLB_CHUNK_BIN && !bin)
+			{
+				bin = data + offset;
+				binSize = chunkLength;
+			}
+
+			offset += (chunkLength + 3) & ~size_t(3);
+		}
+
+		if (json.empty())
+		{
+			errors.report("Missing JSON chunk in GLB file: " + path);
+			return;
+		}
+
+		Asset::ObjectData objAsset;
+
+		try
+		{
+			JsonValue doc = JsonReader(json).parse();
+			GlbReader(doc, bin, binSize, errors).read(objAsset);
+		}
+		catch (const std::exception& e)
+		{
+			errors.report(e.what());
+			return;
+		}
+
+		if (stats) *stats = computeAssetStats(objAsset);
+
+		asset.content_ = std::move(objAsset);
+	}
+
+	void parseGlb(Asset& asset, const std::string& path, ObjErrorCollector& errors, AssetStats *stats)
+	{
+		readGlbFile(asset, path, errors, stats);
+		errors.setFilePath(path);
+	}
+
+	Asset parseGlb(const std::string& path, ObjErrorCollector& errors, AssetStats *stats)
+	{
+		Asset res;
+		parseGlb(res, path, errors, stats);
+		return res;
+	}
+
+}
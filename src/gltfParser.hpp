@@ -0,0 +1,22 @@
+#pragma once
+
+#include "scene-core.hpp"
+#include "objParser.hpp"
+#include "meshStats.hpp"
+#include <string>
+
+namespace sceneIO::parser {
+
+	/**
+	 * glTF 2.0 binary (.glb) geometry importer.
+	 *
+	 * Every glTF mesh becomes a Mesh and every primitive a SubMesh named after
+	 * its material. Vertex and index data is copied straight out of the mapped
+	 * BIN chunk when the accessor layout matches Vertex / uint32_t indices and is
+	 * converted element by element otherwise. Errors are reported the same way
+	 * as for OBJ files, and @p stats is filled as for parseObj.
+	 */
+	void parseGlb(Asset& asset, const std::string& path, ObjErrorCollector& errors, AssetStats *stats = nullptr);
+	Asset parseGlb(const std::string& path, ObjErrorCollector& errors, AssetStats *stats = nullptr);
+
+}
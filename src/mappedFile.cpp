@@ -0,0 +1,109 @@
+#include "mappedFile.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define SCENE_IO_HAS_MMAP 1
+#endif
+
+namespace sceneIO {
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		close();
+		fallback_ = std::move(other.fallback_);
+		data_ = other.mapped_ ? other.data_ : fallback_.data();
+		size_ = other.size_;
+		mapped_ = other.mapped_;
+		opened_ = other.opened_;
+
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.mapped_ = false;
+		other.opened_ = false;
+		return *this;
+	}
+
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+	#ifdef SCENE_IO_HAS_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		size_ = static_cast<size_t>(st.st_size);
+		opened_ = true;
+
+		// mmap refuses zero-length mappings, an empty file is simply an empty view
+		if (size_ == 0)
+		{
+			::close(fd);
+			return true;
+		}
+
+		void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+
+		if (addr != MAP_FAILED)
+		{
+			madvise(addr, size_, MADV_SEQUENTIAL);
+			data_ = static_cast<const uint8_t *>(addr);
+			mapped_ = true;
+			return true;
+		}
+		size_ = 0;
+		opened_ = false;
+	#endif
+
+		std::ifstream in(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+		if (!in.is_open()) return false;
+
+		fallback_.resize(static_cast<size_t>(in.tellg()));
+		in.seekg(0);
+		if (!in.read(reinterpret_cast<char *>(fallback_.data()), static_cast<std::streamsize>(fallback_.size())))
+		{
+			fallback_.clear();
+			return false;
+		}
+
+		data_ = fallback_.data();
+		size_ = fallback_.size();
+		opened_ = true;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+	#ifdef SCENE_IO_HAS_MMAP
+		if (mapped_ && data_)
+			munmap(const_cast<uint8_t *>(data_), size_);
+	#endif
+		fallback_.clear();
+		fallback_.shrink_to_fit();
+		data_ = nullptr;
+		size_ = 0;
+		mapped_ = false;
+		opened_ = false;
+	}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace sceneIO {
+
+	/**
+	 * Read-only view of a whole file. Uses mmap where available and falls back
+	 * to reading the file into an owned buffer otherwise.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& path) { open(path); }
+		~MappedFile() { close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		bool open(const std::string& path);
+		void close();
+
+		bool		   isOpen() const { return opened_; }
+		const uint8_t *data()   const { return data_; }
+		size_t		   size()   const { return size_; }
+
+		std::string_view view() const { return { reinterpret_cast<const char *>(data_), size_ }; }
+
+	private:
+		const uint8_t *data_ = nullptr;
+		size_t size_ = 0;
+		bool mapped_ = false;
+		bool opened_ = false;
+		std::vector<uint8_t> fallback_;
+	};
+
+}
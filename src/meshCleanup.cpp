@@ -0,0 +1,249 @@
+#include "meshCleanup.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sceneIO::parser
+{
+	namespace
+	{
+		struct CellKey
+		{
+			int64_t x, y, z;
+
+			bool operator==(const CellKey& other) const noexcept
+			{
+				return x == other.x && y == other.y && z == other.z;
+			}
+		};
+
+		struct CellKeyHash
+		{
+			size_t operator()(const CellKey& k) const noexcept
+			{
+				uint64_t h = static_cast<uint64_t>(k.x) * 0x9E3779B97F4A7C15ull;
+				h ^= static_cast<uint64_t>(k.y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+				h ^= static_cast<uint64_t>(k.z) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+				return static_cast<size_t>(h);
+			}
+		};
+
+		struct TriangleKey
+		{
+			uint32_t a, b, c;
+
+			bool operator==(const TriangleKey& other) const noexcept
+			{
+				return a == other.a && b == other.b && c == other.c;
+			}
+		};
+
+		struct TriangleKeyHash
+		{
+			size_t operator()(const TriangleKey& k) const noexcept
+			{
+				size_t seed = k.a + 0x9e3779b9;
+				seed ^= k.b + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+				seed ^= k.c + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+				return seed;
+			}
+		};
+
+		// Rotates the triangle so its smallest index comes first, keeping the winding
+		TriangleKey canonicalTriangle(uint32_t a, uint32_t b, uint32_t c)
+		{
+			if (a <= b && a <= c) return { a, b, c };
+			if (b <= a && b <= c) return { b, c, a };
+			return { c, a, b };
+		}
+
+		bool nearlyEqual(const vec3& a, const vec3& b, float eps)
+		{
+			return std::abs(a.x - b.x) <= eps && std::abs(a.y - b.y) <= eps && std::abs(a.z - b.z) <= eps;
+		}
+
+		bool weldable(const Vertex& a, const Vertex& b, float eps)
+		{
+			return nearlyEqual(a.pos, b.pos, eps)
+				&& nearlyEqual(a.normal, b.normal, eps)
+				&& std::abs(a.uv.x - b.uv.x) <= eps && std::abs(a.uv.y - b.uv.y) <= eps;
+		}
+
+		/**
+		 * Maps every vertex to the first earlier vertex matching it within
+		 * @p eps. Cells are eps wide so a match is always in a neighbour cell.
+		 */
+		uint64_t buildWeldRemap(const std::vector<Vertex>& vertices, float eps, std::vector<uint32_t>& remap)
+		{
+			uint64_t welded = 0;
+			double cell = eps > 0.0f ? static_cast<double>(eps) : 1.0;
+			int reach = eps > 0.0f ? 1 : 0;
+			const double maxCell = 0x1p62;
+
+			std::unordered_map<CellKey, std::vector<uint32_t>, CellKeyHash> grid;
+			grid.reserve(vertices.size());
+
+			remap.resize(vertices.size());
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				const vec3& p = vertices[i].pos;
+				remap[i] = static_cast<uint32_t>(i);
+
+				double cx = std::floor(p.x / cell);
+				double cy = std::floor(p.y / cell);
+				double cz = std::floor(p.z / cell);
+
+				// Non-finite or too far for an int64 cell (neighbours included),
+				// such vertices are kept as is like NaNs
+				if (!(std::fabs(cx) < maxCell && std::fabs(cy) < maxCell && std::fabs(cz) < maxCell))
+					continue;
+
+				CellKey key{ static_cast<int64_t>(cx), static_cast<int64_t>(cy), static_cast<int64_t>(cz) };
+
+				uint32_t found = UINT32_MAX;
+				for (int dx = -reach; dx <= reach && found == UINT32_MAX; dx++)
+				for (int dy = -reach; dy <= reach && found == UINT32_MAX; dy++)
+				for (int dz = -reach; dz <= reach && found == UINT32_MAX; dz++)
+				{
+					auto it = grid.find({ key.x + dx, key.y + dy, key.z + dz });
+					if (it == grid.end()) continue;
+
+					for (uint32_t candidate : it->second)
+					{
+						if (weldable(vertices[candidate], vertices[i], eps))
+						{
+							found = candidate;
+							break;
+						}
+					}
+				}
+
+				if (found != UINT32_MAX)
+				{
+					remap[i] = found;
+					welded++;
+				}
+				else grid[key].push_back(static_cast<uint32_t>(i));
+			}
+			return welded;
+		}
+
+		bool isDegenerate(const std::vector<Vertex>& vertices, uint32_t a, uint32_t b, uint32_t c, float eps)
+		{
+			if (a == b || b == c || a == c) return true;
+
+			const vec3& pa = vertices[a].pos;
+			const vec3& pb = vertices[b].pos;
+			const vec3& pc = vertices[c].pos;
+
+			vec3 ab = pb - pa;
+			vec3 ac = pc - pa;
+			vec3 bc = pc - pb;
+			vec3 n = vec3::cross(ab, ac);
+
+			double longest = std::max({ vec3::dot(ab, ab), vec3::dot(ac, ac), vec3::dot(bc, bc) });
+			double area = 0.5 * std::sqrt(static_cast<double>(vec3::dot(n, n)));
+
+			return area <= static_cast<double>(eps) * longest;
+		}
+	}
+
+	CleanupReport cleanupMesh(Mesh& mesh, const CleanupOptions& options)
+	{
+		CleanupReport report;
+		std::vector<Vertex>& vertices = mesh.vertices_;
+
+		if (options.weldVertices && !vertices.empty())
+		{
+			std::vector<uint32_t> remap;
+			report.weldedVertices = buildWeldRemap(vertices, options.weldEpsilon, remap);
+
+			if (report.weldedVertices > 0)
+				for (auto& subMesh : mesh.subMeshes_)
+					for (uint32_t& idx : subMesh->indices_)
+						idx = remap[idx];
+		}
+
+		if (options.removeDegenerate || options.removeDuplicates)
+		{
+			for (auto& subMesh : mesh.subMeshes_)
+			{
+				// Per submesh, the same triangle under two materials is kept
+				std::unordered_set<TriangleKey, TriangleKeyHash> seen;
+				std::vector<uint32_t>& indices = subMesh->indices_;
+				size_t out = 0;
+
+				for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				{
+					uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+
+					if (options.removeDegenerate && isDegenerate(vertices, a, b, c, options.degenerateEpsilon))
+					{
+						report.degenerateTriangles++;
+						continue;
+					}
+
+					if (options.removeDuplicates && !seen.insert(canonicalTriangle(a, b, c)).second)
+					{
+						report.duplicateTriangles++;
+						continue;
+					}
+
+					indices[out++] = a;
+					indices[out++] = b;
+					indices[out++] = c;
+				}
+				indices.resize(out);
+			}
+		}
+
+		if (options.compactVertices && !vertices.empty())
+		{
+			std::vector<uint32_t> newIndex(vertices.size(), UINT32_MAX);
+			uint32_t count = 0;
+
+			// Numbered in vertex order, not first use order, so the layout only shrinks
+			for (auto& subMesh : mesh.subMeshes_)
+				for (uint32_t idx : subMesh->indices_)
+					newIndex[idx] = 0;
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				if (newIndex[i] == UINT32_MAX) continue;
+				newIndex[i] = count;
+				vertices[count++] = vertices[i];
+			}
+
+			report.removedVertices = vertices.size() - count;
+			vertices.resize(count);
+
+			if (report.removedVertices > 0)
+				for (auto& subMesh : mesh.subMeshes_)
+					for (uint32_t& idx : subMesh->indices_)
+						idx = newIndex[idx];
+		}
+
+		return report;
+	}
+
+	CleanupReport cleanupAsset(Asset::ObjectData& object, const CleanupOptions& options)
+	{
+		std::vector<CleanupReport> reports(object.meshes.size());
+
+		sceneIO::parallelFor(object.meshes.size(), [&](size_t i)
+		{
+			reports[i] = cleanupMesh(*object.meshes[i], options);
+		});
+
+		CleanupReport total;
+		for (const CleanupReport& r : reports)
+			total += r;
+		return total;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "scene-core.hpp"
+#include <cstdint>
+
+namespace sceneIO::parser {
+
+	struct CleanupOptions
+	{
+		bool weldVertices = true;
+		float weldEpsilon = 1e-6f;		// max per component distance of welded positions, normals and uvs
+
+		bool removeDegenerate = true;
+		float degenerateEpsilon = 1e-7f;	// triangle area relative to its longest edge squared
+
+		bool removeDuplicates = true;		// same three vertices with the same winding in one submesh
+		bool compactVertices = true;		// drop vertices no triangle uses anymore
+	};
+
+	struct CleanupReport
+	{
+		uint64_t weldedVertices = 0;
+		uint64_t degenerateTriangles = 0;
+		uint64_t duplicateTriangles = 0;
+		uint64_t removedVertices = 0;		// dropped by compaction, welded ones included
+
+		CleanupReport& operator+=(const CleanupReport& other)
+		{
+			weldedVertices += other.weldedVertices;
+			degenerateTriangles += other.degenerateTriangles;
+			duplicateTriangles += other.duplicateTriangles;
+			removedVertices += other.removedVertices;
+			return *this;
+		}
+	};
+
+	/**
+	 * Optional post-parse cleanup: epsilon welding through a spatial hash,
+	 * removal of degenerate and duplicated triangles, then compaction of the
+	 * vertex buffer. Vertex order and triangle order are otherwise preserved.
+	 */
+	CleanupReport cleanupMesh(Mesh& mesh, const CleanupOptions& options = {});
+
+	// Cleans every mesh of @p object in parallel and sums the reports
+	CleanupReport cleanupAsset(Asset::ObjectData& object, const CleanupOptions& options = {});
+
+}
@@ -0,0 +1,187 @@
+#include "meshReorder.hpp"
+#include "meshStats.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace sceneIO::parser
+{
+	namespace
+	{
+		constexpr size_t RADIX_BITS = 8;
+		constexpr size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+		constexpr size_t MIN_ITEMS_PER_CHUNK = 1 << 16;
+
+		// Spreads the 10 low bits of v so there are two zero bits between each
+		uint32_t expandBits(uint32_t v)
+		{
+			v &= 0x3FF;
+			v = (v | (v << 16)) & 0x030000FF;
+			v = (v | (v <<  8)) & 0x0300F00F;
+			v = (v | (v <<  4)) & 0x030C30C3;
+			v = (v | (v <<  2)) & 0x09249249;
+			return v;
+		}
+
+		uint32_t morton3D(float x, float y, float z)
+		{
+			auto quantize = [](float f) -> uint32_t
+			{
+				if (!(f > 0.0f)) return 0;	// also catches NaN
+				if (f >= 1.0f) return 1023;
+				return static_cast<uint32_t>(f * 1023.0f);
+			};
+			return (expandBits(quantize(x)) << 2) | (expandBits(quantize(y)) << 1) | expandBits(quantize(z));
+		}
+
+		/**
+		 * Stable LSD radix sort of (code << 32 | payload) items on their 30 bit
+		 * code. Each pass histograms and scatters independent chunks in parallel.
+		 */
+		void radixSortByCode(std::vector<uint64_t>& items, size_t maxThreads)
+		{
+			size_t n = items.size();
+			if (n < 2) return;
+
+			size_t chunks = std::max<size_t>(1, std::min(maxThreads, n / MIN_ITEMS_PER_CHUNK));
+			size_t chunkSize = (n + chunks - 1) / chunks;
+
+			std::vector<uint64_t> tmp(n);
+			std::vector<std::array<size_t, RADIX_BUCKETS>> offsets(chunks);
+
+			for (size_t shift = 32; shift < 62; shift += RADIX_BITS)
+			{
+				sceneIO::parallelFor(chunks, [&](size_t c)
+				{
+					std::array<size_t, RADIX_BUCKETS>& hist = offsets[c];
+					hist.fill(0);
+					size_t end = std::min(n, (c + 1) * chunkSize);
+					for (size_t i = c * chunkSize; i < end; i++)
+						hist[(items[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+				});
+
+				// Bucket major, chunk minor prefix sum keeps the sort stable
+				size_t sum = 0;
+				for (size_t b = 0; b < RADIX_BUCKETS; b++)
+				{
+					for (size_t c = 0; c < chunks; c++)
+					{
+						size_t count = offsets[c][b];
+						offsets[c][b] = sum;
+						sum += count;
+					}
+				}
+
+				sceneIO::parallelFor(chunks, [&](size_t c)
+				{
+					std::array<size_t, RADIX_BUCKETS>& pos = offsets[c];
+					size_t end = std::min(n, (c + 1) * chunkSize);
+					for (size_t i = c * chunkSize; i < end; i++)
+						tmp[pos[(items[i] >> shift) & (RADIX_BUCKETS - 1)]++] = items[i];
+				});
+
+				items.swap(tmp);
+			}
+		}
+	}
+
+	/**
+	 * @p sortThreads bounds the radix sort workers, 1 when meshes are already
+	 * processed in parallel.
+	 */
+	static void reorderMeshImpl(Mesh& mesh, size_t sortThreads)
+	{
+		std::vector<Vertex>& vertices = mesh.vertices_;
+		if (vertices.empty()) return;
+
+		AABB box = computeBounds(vertices.data(), vertices.size());
+		vec3 extent = box.extent();
+		vec3 inv(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+		         extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+		         extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+		std::vector<uint64_t> items;
+		std::vector<uint32_t> sorted;
+
+		for (auto& subMesh : mesh.subMeshes_)
+		{
+			std::vector<uint32_t>& indices = subMesh->indices_;
+			size_t triangles = indices.size() / 3;
+			if (triangles < 2) continue;
+
+			items.resize(triangles);
+			for (size_t t = 0; t < triangles; t++)
+			{
+				const vec3& a = vertices[indices[3 * t]].pos;
+				const vec3& b = vertices[indices[3 * t + 1]].pos;
+				const vec3& c = vertices[indices[3 * t + 2]].pos;
+
+				float cx = ((a.x + b.x + c.x) / 3.0f - box.min.x) * inv.x;
+				float cy = ((a.y + b.y + c.y) / 3.0f - box.min.y) * inv.y;
+				float cz = ((a.z + b.z + c.z) / 3.0f - box.min.z) * inv.z;
+
+				items[t] = (static_cast<uint64_t>(morton3D(cx, cy, cz)) << 32) | static_cast<uint32_t>(t);
+			}
+
+			radixSortByCode(items, sortThreads);
+
+			sorted.resize(indices.size());
+			for (size_t t = 0; t < triangles; t++)
+			{
+				size_t src = static_cast<uint32_t>(items[t]) * size_t(3);
+				sorted[3 * t] = indices[src];
+				sorted[3 * t + 1] = indices[src + 1];
+				sorted[3 * t + 2] = indices[src + 2];
+			}
+			std::copy(indices.begin() + triangles * 3, indices.end(), sorted.begin() + triangles * 3);
+			indices.swap(sorted);
+		}
+
+		std::vector<uint32_t> newIndex(vertices.size(), UINT32_MAX);
+		std::vector<Vertex> reordered;
+		reordered.reserve(vertices.size());
+
+		for (auto& subMesh : mesh.subMeshes_)
+		{
+			for (uint32_t& idx : subMesh->indices_)
+			{
+				if (newIndex[idx] == UINT32_MAX)
+				{
+					newIndex[idx] = static_cast<uint32_t>(reordered.size());
+					reordered.push_back(vertices[idx]);
+				}
+				idx = newIndex[idx];
+			}
+		}
+
+		// Vertices no triangle uses keep their relative order at the end
+		for (size_t i = 0; i < vertices.size(); i++)
+			if (newIndex[i] == UINT32_MAX)
+				reordered.push_back(vertices[i]);
+
+		vertices.swap(reordered);
+	}
+
+	void reorderMesh(Mesh& mesh)
+	{
+		reorderMeshImpl(mesh, std::max(1u, std::thread::hardware_concurrency()));
+	}
+
+	void reorderAsset(Asset::ObjectData& object)
+	{
+		if (object.meshes.size() == 1)
+		{
+			reorderMesh(*object.meshes[0]);
+			return;
+		}
+
+		sceneIO::parallelFor(object.meshes.size(), [&](size_t i)
+		{
+			reorderMeshImpl(*object.meshes[i], 1);
+		});
+	}
+
+}
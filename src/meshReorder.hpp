@@ -0,0 +1,18 @@
+#pragma once
+
+#include "scene-core.hpp"
+
+namespace sceneIO::parser {
+
+	/**
+	 * Sorts the triangles of every submesh along a Morton curve over the mesh
+	 * AABB (triangle centroids, 10 bits per axis), then renumbers the vertices
+	 * in first-use order of the sorted triangles. Submeshes keep their
+	 * triangles, only the order inside them and the vertex layout change.
+	 */
+	void reorderMesh(Mesh& mesh);
+
+	// Reorders every mesh of @p object in parallel
+	void reorderAsset(Asset::ObjectData& object);
+
+}
@@ -0,0 +1,169 @@
+#include "meshStats.hpp"
+
+#include <cstddef>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define SCENE_IO_HAS_SSE 1
+#endif
+
+namespace sceneIO::parser
+{
+
+	// Position of the i-th reduced vertex is at(i), a pointer to its pos.x
+	template <typename At>
+	static AABB reduceBounds(At at, size_t count)
+	{
+		AABB res;
+		if (count == 0) return res;
+
+	#ifdef SCENE_IO_HAS_SSE
+		// Loads 4 floats starting at pos.x, the 4th lane spills into the next
+		// member and is ignored
+		static_assert(offsetof(Vertex, pos) + 4 * sizeof(float) <= sizeof(Vertex),
+		              "Vertex::pos must be followed by at least one float");
+
+		__m128 lo = _mm_loadu_ps(at(0));
+		__m128 hi = lo;
+		__m128 lo2 = lo;
+		__m128 hi2 = lo;
+
+		size_t i = 1;
+		for (; i + 1 < count; i += 2)
+		{
+			__m128 a = _mm_loadu_ps(at(i));
+			__m128 b = _mm_loadu_ps(at(i + 1));
+			lo = _mm_min_ps(lo, a);
+			hi = _mm_max_ps(hi, a);
+			lo2 = _mm_min_ps(lo2, b);
+			hi2 = _mm_max_ps(hi2, b);
+		}
+		if (i < count)
+		{
+			__m128 a = _mm_loadu_ps(at(i));
+			lo = _mm_min_ps(lo, a);
+			hi = _mm_max_ps(hi, a);
+		}
+		lo = _mm_min_ps(lo, lo2);
+		hi = _mm_max_ps(hi, hi2);
+
+		alignas(16) float mn[4], mx[4];
+		_mm_store_ps(mn, lo);
+		_mm_store_ps(mx, hi);
+
+		res.min = vec3(mn[0], mn[1], mn[2]);
+		res.max = vec3(mx[0], mx[1], mx[2]);
+	#else
+		for (size_t i = 0; i < count; i++)
+		{
+			const float *p = at(i);
+			res.extend(vec3(p[0], p[1], p[2]));
+		}
+	#endif
+		return res;
+	}
+
+	AABB computeBounds(const Vertex *vertices, size_t count)
+	{
+		return reduceBounds([vertices](size_t i) { return &vertices[i].pos.x; }, count);
+	}
+
+	AABB computeBounds(const Vertex *vertices, const uint32_t *indices, size_t count)
+	{
+		return reduceBounds([vertices, indices](size_t i) { return &vertices[indices[i]].pos.x; }, count);
+	}
+
+	static void finalizeMesh(MeshStats& stats, const Mesh& mesh)
+	{
+		std::vector<uint32_t> mark(mesh.vertices_.size(), UINT32_MAX);
+
+		GeometryStats& total = stats.total;
+		total = {};
+
+		stats.subMeshes.resize(mesh.subMeshes_.size());
+
+		for (size_t s = 0; s < mesh.subMeshes_.size(); s++)
+		{
+			GeometryStats& sub = stats.subMeshes[s];
+			const std::vector<uint32_t>& indices = mesh.subMeshes_[s]->indices_;
+			uint32_t id = static_cast<uint32_t>(s);
+
+			// Referenced vertices only, the mesh box is the union of these
+			sub.bounds = computeBounds(mesh.vertices_.data(), indices.data(), indices.size());
+			total.bounds.extend(sub.bounds);
+
+			sub.vertexCount = 0;
+			for (uint32_t idx : indices)
+			{
+				if (mark[idx] == id) continue;
+				if (mark[idx] == UINT32_MAX) total.vertexCount++;
+				mark[idx] = id;
+				sub.vertexCount++;
+			}
+			sub.sphere = BoundingSphere::fromAABB(sub.bounds);
+
+			total.triangleCount += sub.triangleCount;
+			total.surfaceArea += sub.surfaceArea;
+		}
+
+		total.sphere = BoundingSphere::fromAABB(total.bounds);
+	}
+
+	static void accumulateTotals(AssetStats& stats)
+	{
+		stats.total = {};
+
+		for (const MeshStats& mesh : stats.meshes)
+		{
+			stats.total.bounds.extend(mesh.total.bounds);
+			stats.total.triangleCount += mesh.total.triangleCount;
+			stats.total.vertexCount += mesh.total.vertexCount;
+			stats.total.surfaceArea += mesh.total.surfaceArea;
+		}
+
+		stats.total.sphere = BoundingSphere::fromAABB(stats.total.bounds);
+	}
+
+	void finalizeStats(AssetStats& stats, const Asset::ObjectData& object, size_t firstMesh)
+	{
+		stats.meshes.resize(object.meshes.size());
+
+		for (size_t m = firstMesh; m < object.meshes.size(); m++)
+			finalizeMesh(stats.meshes[m], *object.meshes[m]);
+
+		accumulateTotals(stats);
+	}
+
+	MeshStats computeMeshStats(const Mesh& mesh)
+	{
+		MeshStats res;
+		res.subMeshes.resize(mesh.subMeshes_.size());
+
+		for (size_t s = 0; s < mesh.subMeshes_.size(); s++)
+		{
+			const std::vector<uint32_t>& indices = mesh.subMeshes_[s]->indices_;
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				res.subMeshes[s].addTriangle(mesh.vertices_[indices[i]].pos,
+				                             mesh.vertices_[indices[i + 1]].pos,
+				                             mesh.vertices_[indices[i + 2]].pos);
+			}
+		}
+
+		finalizeMesh(res, mesh);
+		return res;
+	}
+
+	AssetStats computeAssetStats(const Asset::ObjectData& object)
+	{
+		AssetStats res;
+		res.meshes.reserve(object.meshes.size());
+
+		for (const auto& mesh : object.meshes)
+			res.meshes.push_back(computeMeshStats(*mesh));
+
+		accumulateTotals(res);
+		return res;
+	}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "scene-core.hpp"
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+namespace sceneIO::parser {
+
+	struct AABB
+	{
+		vec3 min = vec3(std::numeric_limits<float>::max());
+		vec3 max = vec3(std::numeric_limits<float>::lowest());
+
+		bool empty() const { return min.x > max.x; }
+
+		vec3 center() const { return vec3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f); }
+		vec3 extent() const { return max - min; }
+
+		void extend(const vec3& p)
+		{
+			min = vec3(std::fmin(min.x, p.x), std::fmin(min.y, p.y), std::fmin(min.z, p.z));
+			max = vec3(std::fmax(max.x, p.x), std::fmax(max.y, p.y), std::fmax(max.z, p.z));
+		}
+
+		void extend(const AABB& other)
+		{
+			if (other.empty()) return;
+			extend(other.min);
+			extend(other.max);
+		}
+	};
+
+	/**
+	 * Conservative sphere around an AABB (center + half diagonal). Free to get
+	 * from the box, at most sqrt(3) times the radius of the optimal one.
+	 */
+	struct BoundingSphere
+	{
+		vec3 center = vec3(0);
+		float radius = 0.0f;
+
+		static BoundingSphere fromAABB(const AABB& box)
+		{
+			if (box.empty()) return {};
+			vec3 e = box.extent();
+			return { box.center(), std::sqrt(vec3::dot(e, e)) * 0.5f };
+		}
+	};
+
+	struct GeometryStats
+	{
+		AABB bounds;
+		BoundingSphere sphere;
+		uint64_t triangleCount = 0;
+		uint64_t vertexCount = 0;	// distinct vertices referenced
+		double surfaceArea = 0.0;
+
+		// Bounds are left to finalizeStats(), which reduces them over the indices
+		void addTriangle(const vec3& a, const vec3& b, const vec3& c)
+		{
+			vec3 n = vec3::cross(b - a, c - a);
+			surfaceArea += 0.5 * std::sqrt(static_cast<double>(vec3::dot(n, n)));
+			triangleCount++;
+		}
+	};
+
+	struct MeshStats
+	{
+		GeometryStats total;
+		std::vector<GeometryStats> subMeshes;	// same order as Mesh::subMeshes_
+	};
+
+	struct AssetStats
+	{
+		GeometryStats total;
+		std::vector<MeshStats> meshes;			// same order as ObjectData::meshes
+	};
+
+	/**
+	 * Min/max reduction over the positions of a vertex stream (SSE when
+	 * available, scalar otherwise).
+	 */
+	AABB computeBounds(const Vertex *vertices, size_t count);
+
+	/**
+	 * Same reduction over the vertices referenced by an index buffer,
+	 * duplicates included.
+	 */
+	AABB computeBounds(const Vertex *vertices, const uint32_t *indices, size_t count);
+
+	/**
+	 * Stats of an already built mesh, used for meshes that did not come
+	 * through a parser or were modified after parsing.
+	 */
+	MeshStats computeMeshStats(const Mesh& mesh);
+	AssetStats computeAssetStats(const Asset::ObjectData& object);
+
+	/**
+	 * Completes stats accumulated triangle by triangle during a parse: fills
+	 * vertex counts, spheres and the mesh/asset totals. Meshes before
+	 * @p firstMesh are considered up to date.
+	 */
+	void finalizeStats(AssetStats& stats, const Asset::ObjectData& object, size_t firstMesh = 0);
+
+}
@@ -1,42 +1,13 @@
 #include "objParser.hpp"
+#include "parallel.hpp"
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
 #include <functional>
 #include <cstring>
+#include <sstream>
 #include <charconv>
-
-namespace sceneIO::parser
-{
-	struct VertexKey
-	{
-		uint32_t posIndex = 0;
-		uint32_t uvIndex = 0;
-		uint32_t normalIndex = 0;
-
-		bool operator==(const VertexKey& other) const noexcept
-		{
-			return (posIndex == other.posIndex &&
-					uvIndex == other.uvIndex &&
-					normalIndex == other.normalIndex);
-		}
-	};
-}
-
-namespace std
-{
-	template<>
-	struct hash<sceneIO::parser::VertexKey>
-	{
-		size_t operator()(const sceneIO::parser::VertexKey& k) const noexcept
-		{
-			size_t seed = k.posIndex + 0x9e3779b9;
-			seed ^= k.uvIndex + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			seed ^= k.normalIndex + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			return seed;
-		}
-	};
-}
+#include <algorithm>
 
 namespace sceneIO::parser
 {
@@ -246,23 +217,266 @@ namespace sceneIO::parser
 		return true;
 	}
 
-	void parseObj(Asset& asset, std::istream& in, ObjErrorCollector& errors,
-	              uint64_t startLine, uint64_t startColumn)
+	namespace
+	{
+		/**
+		 * Face as recorded by the text scan, before any vertex is built.
+		 */
+		struct PendingFace
+		{
+			uint32_t subMesh;
+			uint32_t firstCorner;
+			uint32_t cornerCount;
+
+			// Attribute pool sizes when the face was read: indices past them are
+			// forward references, rejected as the single pass parser did
+			uint32_t posCount;
+			uint32_t uvCount;
+			uint32_t normalCount;
+
+			uint64_t line;
+			uint64_t column;
+		};
+
+		struct ResolvedFace
+		{
+			uint32_t face;		// index in PendingMesh::faces
+			vec3 normal;		// oriented like the normal of the first vertex
+		};
+
+		/**
+		 * Faces read for one mesh during a parseObjLines call.
+		 */
+		struct PendingMesh
+		{
+			uint32_t meshID = 0;
+
+			std::vector<VertexKey> corners;
+			std::vector<PendingFace> faces;
+			std::unordered_map<VertexKey, uint32_t> vertexMap;
+
+			std::vector<uint32_t> resolved;						// mesh vertex of every corner
+			std::vector<std::vector<ResolvedFace>> bySubMesh;	// valid faces, in file order
+			ObjErrorCollector errors;
+		};
+	}
+
+	/**
+	 * Resolves the VertexKeys of every face of @p pending in file order,
+	 * building the mesh vertices and the face normals. The order matters: a
+	 * vertex without normal takes the normal of the first face using it.
+	 */
+	static void resolveFaces(Mesh& mesh, PendingMesh& pending, const ObjParseState& state)
+	{
+		const std::vector<vec3>& pos    = state.pos;
+		const std::vector<vec3>& normal = state.normal;
+		const std::vector<vec2>& uv     = state.uv;
+
+		std::unordered_map<VertexKey, uint32_t>& vertexMap = pending.vertexMap;
+		std::vector<Vertex>& vertices = mesh.vertices_;
+		ObjErrorCollector& errors = pending.errors;
+
+		pending.resolved.resize(pending.corners.size());
+		pending.bySubMesh.resize(mesh.subMeshes_.size());
+
+		for (size_t f = 0; f < pending.faces.size(); f++)
+		{
+			const PendingFace& face = pending.faces[f];
+			ObjSourceLocation loc{{}, face.line, face.column};
+
+			const VertexKey *keys = pending.corners.data() + face.firstCorner;
+			uint32_t *faceVertexIndexes = pending.resolved.data() + face.firstCorner;
+
+			bool faceMissingNormal = false;
+			bool indexError = false;
+
+			for (uint32_t c = 0; c < face.cornerCount; c++)
+			{
+				const VertexKey& key = keys[c];
+				auto vert = vertexMap.find(key);
+				uint32_t realIndex;
+
+				if (vert == vertexMap.end())
+				{
+					realIndex = static_cast<uint32_t>(vertices.size());
+					Vertex finalVertex;
+
+					if (key.posIndex == 0 || key.posIndex > face.posCount)
+					{
+						errors.report(loc, "Invalid position index in face");
+						indexError = true; break;
+					}
+					finalVertex.pos = pos[key.posIndex - 1];
+
+					if (key.uvIndex == 0)
+						finalVertex.uv = vec2(0);
+					else if (key.uvIndex > face.uvCount)
+					{
+						errors.report(loc, "Invalid UV index in face");
+						indexError = true; break;
+					}
+					else
+						finalVertex.uv = uv[key.uvIndex - 1];
+
+					if (key.normalIndex == 0)
+					{
+						faceMissingNormal = true;
+						finalVertex.normal = vec3(0);
+					}
+					else if (key.normalIndex > face.normalCount)
+					{
+						errors.report(loc, "Invalid normal index in face");
+						indexError = true; break;
+					}
+					else
+						finalVertex.normal = normal[key.normalIndex - 1];
+
+					vertices.push_back(finalVertex);
+					vertexMap[key] = realIndex;
+				}
+				else realIndex = vert->second;
+
+				faceVertexIndexes[c] = realIndex;
+			}
+
+			if (indexError) continue;
+
+			vec3 faceNormal = vec3::cross(
+				vertices[faceVertexIndexes[1]].pos - vertices[faceVertexIndexes[0]].pos,
+				vertices[faceVertexIndexes[2]].pos - vertices[faceVertexIndexes[0]].pos
+			).normalized();
+
+			if (faceMissingNormal)
+			{
+				for (uint32_t c = 0; c < face.cornerCount; c++)
+				{
+					if (vertices[faceVertexIndexes[c]].normal == vec3(0))
+						vertices[faceVertexIndexes[c]].normal = faceNormal;
+				}
+			}
+
+			if (vec3::dot(vertices[faceVertexIndexes[0]].normal, faceNormal) < 0)
+				faceNormal = -faceNormal;
+
+			pending.bySubMesh[face.subMesh].push_back({ static_cast<uint32_t>(f), faceNormal });
+		}
+	}
+
+	/**
+	 * Triangulates the resolved faces of one submesh. Only reads the mesh
+	 * vertices, so submeshes of a mesh can be processed concurrently.
+	 */
+	static void triangulateSubMesh(const Mesh& mesh, SubMesh& subMesh, const PendingMesh& pending,
+	                               uint32_t subMeshID, GeometryStats& subStats, ObjErrorCollector& errors)
+	{
+		const std::vector<Vertex>& vertices = mesh.vertices_;
+		std::vector<uint32_t>& indices = subMesh.indices_;
+		std::vector<uint32_t> polygon;
+
+		for (const ResolvedFace& resolved : pending.bySubMesh[subMeshID])
+		{
+			const PendingFace& face = pending.faces[resolved.face];
+			ObjSourceLocation loc{{}, face.line, face.column};
+
+			const uint32_t *corners = pending.resolved.data() + face.firstCorner;
+			polygon.assign(corners, corners + face.cornerCount);
+
+			vec3 faceNormal = resolved.normal;
+			size_t firstIndex = indices.size();
+
+			earClipping(vertices, polygon, indices, faceNormal, errors, loc);
+
+			for (size_t i = firstIndex; i + 2 < indices.size(); i += 3)
+				subStats.addTriangle(vertices[indices[i]].pos, vertices[indices[i + 1]].pos, vertices[indices[i + 2]].pos);
+		}
+	}
+
+	/**
+	 * Second stage of the parse: vertex assembly runs one mesh per worker,
+	 * then triangulation one submesh per worker. Errors of all stages are
+	 * merged back in line order.
+	 */
+	static void assembleFaces(Asset::ObjectData& objAsset, std::vector<PendingMesh>& pending,
+	                          ObjParseState& state, ObjErrorCollector& scanErrors, ObjErrorCollector& errors)
+	{
+		sceneIO::parallelFor(pending.size(), [&](size_t i)
+		{
+			resolveFaces(*objAsset.meshes[pending[i].meshID], pending[i], state);
+		});
+
+		std::vector<std::pair<size_t, uint32_t>> tasks;
+		for (size_t i = 0; i < pending.size(); i++)
+			for (uint32_t s = 0; s < pending[i].bySubMesh.size(); s++)
+				if (!pending[i].bySubMesh[s].empty())
+					tasks.emplace_back(i, s);
+
+		std::vector<ObjErrorCollector> taskErrors(tasks.size());
+
+		sceneIO::parallelFor(tasks.size(), [&](size_t t)
+		{
+			const auto& [i, s] = tasks[t];
+			const Mesh& mesh = *objAsset.meshes[pending[i].meshID];
+
+			triangulateSubMesh(mesh, *mesh.subMeshes_[s], pending[i], s,
+			                   state.stats.meshes[pending[i].meshID].subMeshes[s], taskErrors[t]);
+		});
+
+		std::vector<ObjError> all(scanErrors.getErrors());
+		for (const PendingMesh& p : pending)
+			all.insert(all.end(), p.errors.getErrors().begin(), p.errors.getErrors().end());
+		for (const ObjErrorCollector& e : taskErrors)
+			all.insert(all.end(), e.getErrors().begin(), e.getErrors().end());
+
+		std::stable_sort(all.begin(), all.end(), [](const ObjError& a, const ObjError& b)
+		{
+			return a.location.line < b.location.line;
+		});
+
+		for (ObjError& e : all)
+			errors.report(std::move(e));
+	}
+
+	static void parseObjLines(Asset::ObjectData& objAsset, std::istream& in, ObjParseState& state,
+	                          const ObjParseOptions& options, ObjErrorCollector& errors,
+	                          uint64_t startLine, uint64_t startColumn)
 	{
 		char line[512];
-		Asset::ObjectData objAsset;
 
-		uint64_t line_count = startLine - 1;
+		uint64_t& line_count = state.lineCount;
+
+		std::vector<vec3>& pos    = state.pos;
+		std::vector<vec3>& normal = state.normal;
+		std::vector<vec2>& uv     = state.uv;
+
+		uint32_t& currentMeshID    = state.currentMeshID;
+		uint32_t& currentSubMeshID = state.currentSubMeshID;
+		std::string& currentMaterial = state.currentMaterial;
 
-		std::vector<vec3> pos;    pos.reserve(1024);
-		std::vector<vec3> normal; normal.reserve(1024);
-		std::vector<vec2> uv;     uv.reserve(1024);
+		// Mesh still open from the previous call, its dedup map lives in the state
+		const uint32_t resumedMeshID = currentMeshID;
+
+		std::vector<PendingMesh> pending;
+		ObjErrorCollector scanErrors;
+
+		auto selectSubMesh = [&]()
+		{
+			if (options.mergeMaterials)
+			{
+				auto it = state.materialSubMeshes.find(currentMaterial);
+				if (it != state.materialSubMeshes.end())
+				{
+					currentSubMeshID = it->second;
+					return;
+				}
+			}
 
-		uint32_t currentMeshID    = static_cast<uint32_t>(-1);
-		uint32_t currentSubMeshID = static_cast<uint32_t>(-1);
-		std::string currentMaterial = "default";
+			objAsset.meshes[currentMeshID]->subMeshes_.push_back(std::make_unique<SubMesh>(currentMaterial));
+			state.stats.meshes[currentMeshID].subMeshes.emplace_back();
+			currentSubMeshID = static_cast<uint32_t>(objAsset.meshes[currentMeshID]->subMeshes_.size() - 1);
 
-		std::unordered_map<VertexKey, uint32_t> vertexMap;
+			if (options.mergeMaterials)
+				state.materialSubMeshes[currentMaterial] = currentSubMeshID;
+		};
 
 		while (in.getline(line, sizeof(line)))
 		{
@@ -280,27 +494,29 @@ namespace sceneIO::parser
 			if (std::strncmp(ptr, "v ", 2) == 0)
 			{
 				vec3 v;
-				if (parseVec3(v, ptr + 2, errors, loc, "Malformed vertex"))
+				if (parseVec3(v, ptr + 2, scanErrors, loc, "Malformed vertex"))
 					pos.push_back(v);
 			}
 			else if (std::strncmp(ptr, "vn ", 3) == 0)
 			{
 				vec3 v;
-				if (parseVec3(v, ptr + 3, errors, loc, "Malformed normal direction"))
+				if (parseVec3(v, ptr + 3, scanErrors, loc, "Malformed normal direction"))
 					normal.push_back(v);
 			}
 			else if (std::strncmp(ptr, "vt ", 3) == 0)
 			{
 				vec2 v;
-				if (parseVec2(v, ptr + 3, errors, loc, "Malformed uv"))
+				if (parseVec2(v, ptr + 3, scanErrors, loc, "Malformed uv"))
 					uv.push_back(v);
 			}
 			else if (std::strncmp(ptr, "o ", 2) == 0)
 			{
 				objAsset.meshes.push_back(std::make_unique<Mesh>(std::string(ptr + 2)));
+				state.stats.meshes.emplace_back();
 				currentMeshID++;
 				currentSubMeshID = static_cast<uint32_t>(-1);
-				vertexMap.clear();
+				state.vertexMap.clear();
+				state.materialSubMeshes.clear();
 			}
 			else if (std::strncmp(ptr, "usemtl ", 7) == 0)
 			{
@@ -308,124 +524,90 @@ namespace sceneIO::parser
 
 				if (currentMeshID == static_cast<uint32_t>(-1)) continue;
 
-				objAsset.meshes[currentMeshID]->subMeshes_.push_back(std::make_unique<SubMesh>(currentMaterial));
-				currentSubMeshID++;
+				selectSubMesh();
 			}
 			else if (std::strncmp(ptr, "f ", 2) == 0)
 			{
 				if (currentMeshID == static_cast<uint32_t>(-1))
 				{
 					objAsset.meshes.push_back(std::make_unique<Mesh>("Default"));
+					state.stats.meshes.emplace_back();
 					currentMeshID++;
 					currentSubMeshID = static_cast<uint32_t>(-1);
+					state.materialSubMeshes.clear();
 				}
 				if (currentSubMeshID == static_cast<uint32_t>(-1))
+					selectSubMesh();
+
+				if (pending.empty() || pending.back().meshID != currentMeshID)
 				{
-					objAsset.meshes[currentMeshID]->subMeshes_.push_back(std::make_unique<SubMesh>(currentMaterial));
-					currentSubMeshID++;
+					PendingMesh& p = pending.emplace_back();
+					p.meshID = currentMeshID;
+					if (currentMeshID == resumedMeshID)
+					{
+						p.vertexMap = std::move(state.vertexMap);
+						state.vertexMap.clear();
+					}
 				}
+				PendingMesh& mesh = pending.back();
 
-				std::vector<VertexKey> faceVertex;
+				uint32_t firstCorner = static_cast<uint32_t>(mesh.corners.size());
 				const char *str = ptr + 2;
 
 				VertexKey tmp;
-				while (parseFaceVertex(tmp, str, errors, loc))
+				while (parseFaceVertex(tmp, str, scanErrors, loc))
 				{
-					faceVertex.push_back(tmp);
+					mesh.corners.push_back(tmp);
 					tmp = {0, 0, 0};
 				}
 
-				if (faceVertex.size() < 3)
+				uint32_t cornerCount = static_cast<uint32_t>(mesh.corners.size()) - firstCorner;
+				if (cornerCount < 3)
 				{
-					errors.report(loc, "Invalid vertex count on the face");
+					scanErrors.report(loc, "Invalid vertex count on the face");
+					mesh.corners.resize(firstCorner);
 					continue;
 				}
 
-				std::vector<uint32_t> faceVertexIndexes;
-				faceVertexIndexes.reserve(faceVertex.size());
-
-				bool faceMissingNormal = false;
-				bool indexError = false;
-
-				for (auto vertexKeyIt = faceVertex.begin(); vertexKeyIt != faceVertex.end(); ++vertexKeyIt)
-				{
-					auto vert = vertexMap.find(*vertexKeyIt);
-					uint32_t realIndex;
-
-					if (vert == vertexMap.end())
-					{
-						realIndex = static_cast<uint32_t>(objAsset.meshes[currentMeshID]->vertices_.size());
-						Vertex finalVertex;
-
-						if (vertexKeyIt->posIndex == 0 || vertexKeyIt->posIndex > pos.size())
-						{
-							errors.report(loc, "Invalid position index in face");
-							indexError = true; break;
-						}
-						finalVertex.pos = pos[vertexKeyIt->posIndex - 1];
-
-						if (vertexKeyIt->uvIndex == 0)
-							finalVertex.uv = vec2(0);
-						else if (vertexKeyIt->uvIndex > uv.size())
-						{
-							errors.report(loc, "Invalid UV index in face");
-							indexError = true; break;
-						}
-						else
-							finalVertex.uv = uv[vertexKeyIt->uvIndex - 1];
-
-						if (vertexKeyIt->normalIndex == 0)
-						{
-							faceMissingNormal = true;
-							finalVertex.normal = vec3(0);
-						}
-						else if (vertexKeyIt->normalIndex > normal.size())
-						{
-							errors.report(loc, "Invalid normal index in face");
-							indexError = true; break;
-						}
-						else
-							finalVertex.normal = normal[vertexKeyIt->normalIndex - 1];
-
-						objAsset.meshes[currentMeshID]->vertices_.push_back(finalVertex);
-						vertexMap[*vertexKeyIt] = realIndex;
-					}
-					else realIndex = vert->second;
+				mesh.faces.push_back({
+					currentSubMeshID, firstCorner, cornerCount,
+					static_cast<uint32_t>(pos.size()), static_cast<uint32_t>(uv.size()), static_cast<uint32_t>(normal.size()),
+					loc.line, loc.column
+				});
+			}
+		}
 
-					faceVertexIndexes.push_back(realIndex);
-				}
+		assembleFaces(objAsset, pending, state, scanErrors, errors);
 
-				if (indexError) continue;
+		if (!pending.empty() && pending.back().meshID == currentMeshID)
+			state.vertexMap = std::move(pending.back().vertexMap);
+	}
 
-				vec3 faceNormal = vec3::cross(
-					objAsset.meshes[currentMeshID]->vertices_[faceVertexIndexes[1]].pos -
-					objAsset.meshes[currentMeshID]->vertices_[faceVertexIndexes[0]].pos,
-					objAsset.meshes[currentMeshID]->vertices_[faceVertexIndexes[2]].pos -
-					objAsset.meshes[currentMeshID]->vertices_[faceVertexIndexes[0]].pos
-				).normalized();
+	void parseObj(Asset& asset, std::istream& in, ObjErrorCollector& errors,
+	              uint64_t startLine, uint64_t startColumn, AssetStats *stats,
+	              const ObjParseOptions& options)
+	{
+		Asset::ObjectData objAsset;
+		ObjParseState state;
 
-				if (faceMissingNormal)
-				{
-					for (uint32_t idx : faceVertexIndexes)
-					{
-						if (objAsset.meshes[currentMeshID]->vertices_[idx].normal == vec3(0))
-							objAsset.meshes[currentMeshID]->vertices_[idx].normal = faceNormal;
-					}
-				}
+		state.lineCount = startLine - 1;
+		state.pos.reserve(1024);
+		state.normal.reserve(1024);
+		state.uv.reserve(1024);
 
-				if (vec3::dot(objAsset.meshes[currentMeshID]->vertices_[faceVertexIndexes[0]].normal, faceNormal) < 0)
-					faceNormal = -faceNormal;
+		parseObjLines(objAsset, in, state, options, errors, startLine, startColumn);
 
-				earClipping(objAsset.meshes[currentMeshID]->vertices_, faceVertexIndexes,
-				            objAsset.meshes[currentMeshID]->subMeshes_[currentSubMeshID]->indices_,
-				            faceNormal, errors, loc);
-			}
+		if (stats)
+		{
+			finalizeStats(state.stats, objAsset);
+			*stats = std::move(state.stats);
 		}
 
 		asset.content_ = std::move(objAsset);
 	}
 
-	void parseObj(Asset& asset, const std::string& path, ObjErrorCollector& errors)
+	void parseObj(Asset& asset, const std::string& path, ObjErrorCollector& errors, AssetStats *stats,
+	              const ObjParseOptions& options)
 	{
 		std::ifstream in(path, std::ios_base::in);
 		if (!in.is_open())
@@ -434,15 +616,61 @@ namespace sceneIO::parser
 			return;
 		}
 
-		parseObj(asset, in, errors);
+		parseObj(asset, in, errors, 1, 1, stats, options);
 		errors.setFilePath(path);
 	}
 
-	Asset parseObj(const std::string& path, ObjErrorCollector& errors)
+	Asset parseObj(const std::string& path, ObjErrorCollector& errors, AssetStats *stats,
+	               const ObjParseOptions& options)
 	{
 		Asset res;
-		parseObj(res, path, errors);
+		parseObj(res, path, errors, stats, options);
 		return res;
 	}
 
+	void parseObjIncremental(Asset& asset, const std::string& path, ObjParseState& state, ObjErrorCollector& errors,
+	                         const ObjParseOptions& options)
+	{
+		std::ifstream in(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+		if (!in.is_open())
+		{
+			errors.report("Cannot open file: " + path);
+			errors.setFilePath(path);
+			return;
+		}
+
+		uint64_t size = static_cast<uint64_t>(in.tellg());
+
+		if (size < state.offset || !std::holds_alternative<Asset::ObjectData>(asset.content_))
+			state.reset();
+		if (state.offset == 0)
+			asset.content_ = Asset::ObjectData();
+
+		if (size == state.offset) return;
+
+		std::string tail(size - state.offset, '\0');
+		in.seekg(static_cast<std::streamoff>(state.offset));
+		if (!in.read(tail.data(), static_cast<std::streamsize>(tail.size())))
+		{
+			errors.report("Cannot read file: " + path);
+			errors.setFilePath(path);
+			return;
+		}
+
+		// The writer may be in the middle of a record, keep it for the next call
+		size_t complete = tail.rfind('\n');
+		if (complete == std::string::npos) return;
+		tail.resize(complete + 1);
+
+		Asset::ObjectData& objAsset = std::get<Asset::ObjectData>(asset.content_);
+		size_t firstTouchedMesh = (state.currentMeshID == static_cast<uint32_t>(-1)) ? 0 : state.currentMeshID;
+
+		std::istringstream stream(std::move(tail));
+		parseObjLines(objAsset, stream, state, options, errors, 1, 1);
+		finalizeStats(state.stats, objAsset, firstTouchedMesh);
+
+		state.offset += complete + 1;
+		errors.setFilePath(path);
+	}
+
 }
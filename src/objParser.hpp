@@ -2,9 +2,44 @@
 
 #include "scene-core.hpp"
 #include "../src/tdr/error.hpp"
+#include "meshStats.hpp"
 #include <istream>
 #include <vector>
 #include <string>
+#include <unordered_map>
+
+namespace sceneIO::parser {
+
+	struct VertexKey
+	{
+		uint32_t posIndex = 0;
+		uint32_t uvIndex = 0;
+		uint32_t normalIndex = 0;
+
+		bool operator==(const VertexKey& other) const noexcept
+		{
+			return (posIndex == other.posIndex &&
+					uvIndex == other.uvIndex &&
+					normalIndex == other.normalIndex);
+		}
+	};
+
+}
+
+namespace std
+{
+	template<>
+	struct hash<sceneIO::parser::VertexKey>
+	{
+		size_t operator()(const sceneIO::parser::VertexKey& k) const noexcept
+		{
+			size_t seed = k.posIndex + 0x9e3779b9;
+			seed ^= k.uvIndex + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= k.normalIndex + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+}
 
 namespace sceneIO::parser {
 
@@ -31,6 +66,11 @@ namespace sceneIO::parser {
 			errors_.push_back({{{}, UINT64_MAX, UINT64_MAX}, msg});
 		}
 
+		void report(ObjError error)
+		{
+			errors_.push_back(std::move(error));
+		}
+
 		void setFilePath(const std::string& path)
 		{
 			for (ObjError& e : errors_)
@@ -44,10 +84,62 @@ namespace sceneIO::parser {
 		std::vector<ObjError> errors_;
 	};
 
+	struct ObjParseOptions
+	{
+		// One SubMesh per material and Mesh, appended to whenever the material
+		// is used again. When false every usemtl starts a new SubMesh, in file order.
+		bool mergeMaterials = true;
+	};
+
+	/**
+	 * Everything the OBJ parser needs to resume where it stopped: the global
+	 * attribute pools, the vertex dedup map of the current object and the
+	 * current mesh/submesh. Kept by the caller between two
+	 * parseObjIncremental calls on the same file.
+	 */
+	struct ObjParseState
+	{
+		std::vector<vec3> pos;
+		std::vector<vec3> normal;
+		std::vector<vec2> uv;
+
+		std::unordered_map<VertexKey, uint32_t> vertexMap;
+
+		uint32_t currentMeshID    = static_cast<uint32_t>(-1);
+		uint32_t currentSubMeshID = static_cast<uint32_t>(-1);
+		std::string currentMaterial = "default";
+		std::unordered_map<std::string, uint32_t> materialSubMeshes;	// of the current mesh
+
+		AssetStats stats;		// triangle stats accumulated so far
+
+		uint64_t offset = 0;	// bytes of the file already parsed
+		uint64_t lineCount = 0;	// lines of the file already parsed
+
+		void reset() { *this = ObjParseState(); }
+	};
+
+	/**
+	 * When @p stats is set it receives the bounds, triangle/vertex counts and
+	 * surface area of every mesh and submesh, accumulated while the faces are
+	 * triangulated.
+	 */
 	void parseObj(Asset& asset, std::istream& in, ObjErrorCollector& errors,
-				  uint64_t startLine = 1, uint64_t startColumn = 1);
+				  uint64_t startLine = 1, uint64_t startColumn = 1, AssetStats *stats = nullptr,
+				  const ObjParseOptions& options = {});
+
+	void parseObj(Asset& asset, const std::string& path, ObjErrorCollector& errors, AssetStats *stats = nullptr,
+				  const ObjParseOptions& options = {});
+	Asset parseObj(const std::string& path, ObjErrorCollector& errors, AssetStats *stats = nullptr,
+				   const ObjParseOptions& options = {});
 
-	void parseObj(Asset& asset, const std::string& path, ObjErrorCollector& errors);
-	Asset parseObj(const std::string& path, ObjErrorCollector& errors);
+	/**
+	 * Parses only the complete lines appended to @p path since the last call
+	 * and extends the meshes already stored in @p asset. A trailing partial
+	 * line is left for the next call. Falls back to a full parse when @p state
+	 * is fresh, the asset holds no object data, or the file shrank.
+	 * Up to date stats are available in @p state.stats after each call.
+	 */
+	void parseObjIncremental(Asset& asset, const std::string& path, ObjParseState& state, ObjErrorCollector& errors,
+							 const ObjParseOptions& options = {});
 
 }
@@ -0,0 +1,234 @@
+#include "objWriter.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace sceneIO::parser
+{
+	namespace
+	{
+		constexpr size_t chunkLines = 1 << 16;
+
+		// Upper bounds of a formatted line: 3 floats of at most 15 chars, or
+		// 3 corners of 3 uint64 indices
+		constexpr size_t maxVertexLine = 3 + 3 * 16 + 1;
+		constexpr size_t maxFaceLine   = 2 + 3 * (3 * 20 + 3) + 1;
+
+		struct MeshLayout
+		{
+			std::vector<uint32_t> order;	// source vertex of every written vertex
+			std::vector<uint32_t> remap;	// written index of every source vertex
+			uint64_t base = 0;				// OBJ index of the first written vertex, minus one
+		};
+
+		enum class ChunkKind { Object, Vertices, Triangles };
+
+		/**
+		 * Slice of the output formatted by one worker: the "o" line of a mesh,
+		 * a range of its vertices or a range of triangles of a submesh.
+		 */
+		struct Chunk
+		{
+			ChunkKind kind;
+			uint32_t mesh;
+			uint32_t subMesh;
+			size_t begin;
+			size_t end;
+		};
+
+		/**
+		 * Numbers the vertices of @p mesh in first use order, which is the
+		 * order parseObj creates them in when reading the faces back.
+		 */
+		void buildLayout(const Mesh& mesh, MeshLayout& layout)
+		{
+			layout.remap.assign(mesh.vertices_.size(), UINT32_MAX);
+			layout.order.clear();
+
+			for (const auto& subMesh : mesh.subMeshes_)
+			{
+				const std::vector<uint32_t>& indices = subMesh->indices_;
+				size_t count = indices.size() - indices.size() % 3;
+
+				for (size_t i = 0; i < count; i++)
+				{
+					uint32_t idx = indices[i];
+					if (layout.remap[idx] != UINT32_MAX) continue;
+					layout.remap[idx] = static_cast<uint32_t>(layout.order.size());
+					layout.order.push_back(idx);
+				}
+			}
+		}
+
+		inline char *putFloat(char *p, float v)
+		{
+			return std::to_chars(p, p + 16, v).ptr;
+		}
+
+		inline char *putIndex(char *p, uint64_t v)
+		{
+			return std::to_chars(p, p + 20, v).ptr;
+		}
+
+		inline char *putVec3(char *p, const char *tag, const vec3& v)
+		{
+			*p++ = tag[0];
+			if (tag[1]) *p++ = tag[1];
+			*p++ = ' '; p = putFloat(p, v.x);
+			*p++ = ' '; p = putFloat(p, v.y);
+			*p++ = ' '; p = putFloat(p, v.z);
+			*p++ = '\n';
+			return p;
+		}
+
+		void formatVertices(std::string& out, const Mesh& mesh, const MeshLayout& layout, size_t begin, size_t end)
+		{
+			out.resize(3 * (end - begin) * maxVertexLine);
+			char *p = out.data();
+
+			for (size_t i = begin; i < end; i++)
+				p = putVec3(p, "v", mesh.vertices_[layout.order[i]].pos);
+
+			for (size_t i = begin; i < end; i++)
+			{
+				const vec2& uv = mesh.vertices_[layout.order[i]].uv;
+				*p++ = 'v'; *p++ = 't';
+				*p++ = ' '; p = putFloat(p, uv.x);
+				*p++ = ' '; p = putFloat(p, uv.y);
+				*p++ = '\n';
+			}
+
+			for (size_t i = begin; i < end; i++)
+				p = putVec3(p, "vn", mesh.vertices_[layout.order[i]].normal);
+
+			out.resize(static_cast<size_t>(p - out.data()));
+		}
+
+		void formatTriangles(std::string& out, const Mesh& mesh, const MeshLayout& layout,
+		                     uint32_t subMeshID, size_t begin, size_t end)
+		{
+			const SubMesh& subMesh = *mesh.subMeshes_[subMeshID];
+			const std::vector<uint32_t>& indices = subMesh.indices_;
+
+			out.clear();
+			if (begin == 0)
+				out.append("usemtl ").append(subMesh.material_).append("\n");
+
+			size_t header = out.size();
+			out.resize(header + (end - begin) * maxFaceLine);
+			char *p = out.data() + header;
+
+			for (size_t t = begin; t < end; t++)
+			{
+				*p++ = 'f';
+				for (size_t c = 0; c < 3; c++)
+				{
+					// Same index in the three pools, one v/vt/vn triple per vertex
+					uint64_t idx = layout.base + layout.remap[indices[3 * t + c]] + 1;
+					*p++ = ' '; p = putIndex(p, idx);
+					*p++ = '/'; p = putIndex(p, idx);
+					*p++ = '/'; p = putIndex(p, idx);
+				}
+				*p++ = '\n';
+			}
+
+			out.resize(static_cast<size_t>(p - out.data()));
+		}
+	}
+
+	void writeObj(const Asset& asset, const std::string& path, ObjErrorCollector& errors)
+	{
+		const auto *object = std::get_if<Asset::ObjectData>(&asset.content_);
+		if (!object)
+		{
+			errors.report("Asset has no mesh data to write: " + path);
+			return;
+		}
+
+		const size_t meshCount = object->meshes.size();
+		std::vector<MeshLayout> layouts(meshCount);
+
+		sceneIO::parallelFor(meshCount, [&](size_t m)
+		{
+			buildLayout(*object->meshes[m], layouts[m]);
+		});
+
+		std::vector<Chunk> chunks;
+		uint64_t base = 0;
+
+		for (uint32_t m = 0; m < meshCount; m++)
+		{
+			const Mesh& mesh = *object->meshes[m];
+			layouts[m].base = base;
+			base += layouts[m].order.size();
+
+			chunks.push_back({ ChunkKind::Object, m, 0, 0, 0 });
+
+			for (size_t v = 0; v < layouts[m].order.size(); v += chunkLines)
+				chunks.push_back({ ChunkKind::Vertices, m, 0, v, std::min(v + chunkLines, layouts[m].order.size()) });
+
+			for (uint32_t s = 0; s < mesh.subMeshes_.size(); s++)
+			{
+				size_t triangles = mesh.subMeshes_[s]->indices_.size() / 3;
+				size_t t = 0;
+				do
+				{
+					chunks.push_back({ ChunkKind::Triangles, m, s, t, std::min(t + chunkLines, triangles) });
+					t += chunkLines;
+				} while (t < triangles);
+			}
+		}
+
+		std::FILE *file = std::fopen(path.c_str(), "wb");
+		if (!file)
+		{
+			errors.report("Cannot open file for writing: " + path);
+			return;
+		}
+		// Chunks are already large, every fwrite goes straight to one write call
+		std::setvbuf(file, nullptr, _IONBF, 0);
+
+		// Chunks are formatted a batch at a time to bound memory on huge meshes
+		const size_t batchSize = 2 * std::max(1u, std::thread::hardware_concurrency());
+		std::vector<std::string> buffers(std::min(batchSize, chunks.size()));
+		bool ok = true;
+
+		for (size_t first = 0; ok && first < chunks.size(); first += batchSize)
+		{
+			size_t count = std::min(batchSize, chunks.size() - first);
+
+			sceneIO::parallelFor(count, [&](size_t i)
+			{
+				const Chunk& chunk = chunks[first + i];
+				const Mesh& mesh = *object->meshes[chunk.mesh];
+				std::string& out = buffers[i];
+
+				switch (chunk.kind)
+				{
+				case ChunkKind::Object:
+					out.assign("o ").append(mesh.name_).append("\n");
+					break;
+				case ChunkKind::Vertices:
+					formatVertices(out, mesh, layouts[chunk.mesh], chunk.begin, chunk.end);
+					break;
+				case ChunkKind::Triangles:
+					formatTriangles(out, mesh, layouts[chunk.mesh], chunk.subMesh, chunk.begin, chunk.end);
+					break;
+				}
+			});
+
+			for (size_t i = 0; ok && i < count; i++)
+				ok = std::fwrite(buffers[i].data(), 1, buffers[i].size(), file) == buffers[i].size();
+		}
+
+		if (std::fclose(file) != 0) ok = false;
+
+		if (!ok)
+			errors.report("Cannot write file: " + path);
+	}
+
+}
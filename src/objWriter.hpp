@@ -0,0 +1,24 @@
+#pragma once
+
+#include "scene-core.hpp"
+#include "objParser.hpp"
+#include <string>
+
+namespace sceneIO::parser {
+
+	/**
+	 * Writes the meshes of @p asset as an OBJ file readable by parseObj.
+	 *
+	 * Every Mesh becomes an "o" block and every SubMesh a "usemtl" group of
+	 * triangles. Each vertex gets its own v/vt/vn triple, numbered in first use
+	 * order, and floats are written in their shortest round-trip form, so
+	 * parsing the file back gives the same vertices and indices (unreferenced
+	 * vertices are dropped). SubMeshes sharing a material are only kept apart
+	 * when read back with ObjParseOptions::mergeMaterials off.
+	 *
+	 * Text is formatted in parallel chunks and each chunk is written with a
+	 * single write. I/O errors are reported to @p errors.
+	 */
+	void writeObj(const Asset& asset, const std::string& path, ObjErrorCollector& errors);
+
+}
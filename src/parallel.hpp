@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sceneIO {
+
+	/**
+	 * Runs fn(i) for every i in [0, count) on up to @p maxThreads threads
+	 * (hardware concurrency when 0). Items are handed out one by one, so it
+	 * suits a few heavy and unbalanced items such as meshes. The first
+	 * exception thrown by a worker is rethrown on the calling thread.
+	 */
+	template <typename Fn>
+	void parallelFor(size_t count, Fn&& fn, size_t maxThreads = 0)
+	{
+		size_t threads = maxThreads ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+		threads = std::min(threads, count);
+
+		if (threads <= 1)
+		{
+			for (size_t i = 0; i < count; i++)
+				fn(i);
+			return;
+		}
+
+		std::atomic<size_t> next{0};
+		std::exception_ptr error;
+		std::mutex errorMutex;
+
+		auto worker = [&]()
+		{
+			try
+			{
+				for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+					fn(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error) error = std::current_exception();
+				next.store(count);
+			}
+		};
+
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (size_t t = 1; t < threads; t++)
+			pool.emplace_back(worker);
+
+		worker();
+
+		for (std::thread& th : pool)
+			th.join();
+
+		if (error) std::rethrow_exception(error);
+	}
+
+}
@@ -3,28 +3,32 @@
 #include "tdr/semanticAnalyzer.hpp"
 #include "logger.hpp"
 
+#include <cctype>
 #include <iomanip>
 
 namespace sceneIO::tdr {
 
-ParseResult SceneLanguageService::parse_content(const std::string& content, const std::string& filePath)
+ParseResult SceneLanguageService::parse_content(const std::string& content, const std::string& filePath, const SceneSchema& schema)
+{
+	ParseContext context;
+	return parse_content(content, filePath, context, schema);
+}
+
+ParseResult SceneLanguageService::parse_content(const std::string& content, const std::string& filePath, ParseContext& context, const SceneSchema& schema)
 {
 	ErrorCollector errors;
 
 	try
 	{
-		std::istringstream stream(content);
-
-		auto tokens = lexer(stream, errors);
-		Node ast = parser(tokens, errors);
+		auto source = context.acquireSource(content);
+		Ast ast = parseParallel(*source, errors, context);
 
-		SceneSchema sch;
-		semanticAnalyzer(ast, sch, errors, filePath);
+		semanticAnalyzer(ast, schema, errors, filePath);
 
 		if (!filePath.empty())
 			errors.setFilePath(filePath);
 
-		return {std::move(ast), errors.get_errors()};
+		return {std::move(ast), errors.get_errors(), std::move(source)};
 	}
 	catch(const TdrError& e)
 	{		
@@ -34,27 +38,25 @@ ParseResult SceneLanguageService::parse_content(const std::string& content, cons
 	{
 		errors.report(TdrError(e.what()));
 	}
-	Node empty;
+	Ast empty;
 	return {std::move(empty), errors.get_errors()};
 }
 
-ParseResult SceneLanguageService::parse_file(const std::string& path)
+ParseResult SceneLanguageService::parse_file(const std::string& path, const SceneSchema& schema)
 {
 	ErrorCollector errors;
 
 	try
 	{
-		std::ifstream in(path, std::ios_base::in);
-		if (!in.is_open()) throw TdrError("Cannot open file");
+		auto source = TokenSource::fromFile(path);
+		if (!source) throw TdrError("Cannot open file");
 
-		auto tokens = lexer(in, errors);
-		Node ast = parser(tokens, errors);
+		Ast ast = parseParallel(*source, errors);
 
-		SceneSchema sch;
-		semanticAnalyzer(ast, sch, errors, path);
+		semanticAnalyzer(ast, schema, errors, path);
 
 		errors.setFilePath(path);
-		return {std::move(ast), errors.get_errors()};
+		return {std::move(ast), errors.get_errors(), std::move(source)};
 	}
 	catch(TdrError& e)
 	{
@@ -66,7 +68,7 @@ ParseResult SceneLanguageService::parse_file(const std::string& path)
 		SourceLocation loc = { .filepath = path };
 		errors.report(TdrError(loc, e.what()));
 	}
-	Node empty;
+	Ast empty;
 	return {std::move(empty), errors.get_errors()};
 }
 
@@ -100,48 +102,52 @@ static std::string formatTagHover(const TagSchema& tag)
 {
 	std::ostringstream out;
 
-	auto conditionalAttributeName = [&]() -> std::string
+	const ConditionalVariant *condition = tag.fromCondition();
+
+	auto conditionalAttributeName = [&]() -> Symbol
 	{
-		if (tag.fromCondition.has_value()) return tag.fromCondition.value().first;
-		return "";
+		if (condition) return condition->discriminator_attr;
+		return {};
 	};
 
 	out << "```xml\n<" << tag.name;
-	if (tag.fromCondition.has_value())
-		out << " " << tag.fromCondition.value().first << "=\"" << tag.fromCondition.value().second << "\"";
-
-	for (auto& [name, attr] : tag.attributes)
-		if (attr.required && name != conditionalAttributeName())
-			out << " " << name << "=\"...\"";
-	for (auto& [name, attr] : tag.attributes)
-		if (!attr.required && name != conditionalAttributeName())
-			out << " [" << name << "=\"...\"]";
+	if (condition)
+		out << " " << condition->discriminator_attr << "=\"" << condition->discriminator_value << "\"";
+
+	for (const AttributeSchema& attr : tag.attributes())
+		if (attr.required && attr.key != conditionalAttributeName())
+			out << " " << attr.key << "=\"...\"";
+	for (const AttributeSchema& attr : tag.attributes())
+		if (!attr.required && attr.key != conditionalAttributeName())
+			out << " [" << attr.key << "=\"...\"]";
 	out << ">\n```\n---\n";
 
 	if (!tag.hover_info.empty()) out << tag.hover_info << "\n\n";
 
-	if (tag.children.size() == 1) out << "**Child**\n\n";
-	else if (tag.children.size() > 1) out << "**Children**\n\n";
-	for (auto& [name, child] : tag.children)
+	const auto children = tag.children();
+	if (children.size() == 1) out << "**Child**\n\n";
+	else if (children.size() > 1) out << "**Children**\n\n";
+	for (const TagSchema& child : children)
 	{
-		out << "- `<" << name << ">`";
+		out << "- `<" << child.key << ">`";
 		out << (child.required ? " *(required)*" : " *(optional)*");
 
-		if (child.allow_text && child.text_type) out << " — " << formatValueType(child.text_type.value(), child.range);
+		if (child.allow_text && child.has_text_type) out << " — " << formatValueType(child.text_type, child.range());
 
-		if (!child.enum_values.empty() && child.enum_values.size() <= 4)
+		const auto enumValues = child.enumValues();
+		if (!enumValues.empty() && enumValues.size() <= 4)
 		{
 			out << " — ";
-			for (size_t i = 0; i < child.enum_values.size(); ++i)
+			for (size_t i = 0; i < enumValues.size(); ++i)
 			{
 				if (i) out << " | ";
-				out << "`" << child.enum_values[i] << "`";
+				out << "`" << enumValues[i] << "`";
 			}
 		}
 		out << "\n";
 	}
 
-	if (!tag.examples.empty()) out << "*Exemple :*\n```xml\n" << tag.examples[0] << "\n```\n";
+	if (!tag.examples().empty()) out << "*Exemple :*\n```xml\n" << tag.examples()[0] << "\n```\n";
 
 	return out.str();
 }
@@ -151,27 +157,28 @@ static std::string formatAttributeHover(const AttributeSchema& attr, const std::
 	std::ostringstream out;
 
 	out << "```\n(attribute) " << attr.name << ": ";
-	out << formatValueType(attr.type, attr.range);
-	if (attr.default_value)
-		out << " = " << *attr.default_value;
+	out << formatValueType(attr.type, attr.range());
+	if (attr.has_default)
+		out << " = " << attr.default_text;
 	out << "\n```\n---\n";
 
 	if (!attr.hover_info.empty())
 		out << attr.hover_info << "\n\n";
 
-	if (!attr.enum_values.empty())
+	const auto enumValues = attr.enumValues();
+	if (!enumValues.empty())
 	{
 		out << "*Values :* ";
-		for (size_t i = 0; i < attr.enum_values.size(); ++i)
+		for (size_t i = 0; i < enumValues.size(); ++i)
 		{
 			if (i) out << " | ";
-			out << "`" << attr.enum_values[i] << "`";
+			out << "`" << enumValues[i] << "`";
 		}
 		out << "\n\n";
 	}
 
-	if (!attr.examples.empty())
-		out << "*Exemple :* `" << attr.examples[0] << "`\n";
+	if (!attr.examples().empty())
+		out << "*Exemple :* `" << attr.examples()[0] << "`\n";
 
 	return out.str();
 }
@@ -179,14 +186,24 @@ static std::string formatAttributeHover(const AttributeSchema& attr, const std::
 
 std::string SceneLanguageService::find_hover_recursive(const Node& node, const TagSchema& schema, size_t line, size_t col)
 {
-	const auto& tokens = node.getTokens();
+	const TokenSource *source = node.getSource();
+	const size_t nameSize = node.getIdentifier().size();
 
-	for (const auto& token : tokens)
+	// Tag name in the start tag (if it is not missing) and in the end tag
+	for (uint32_t offset : { node.getNodeBeginOffset(), node.getEndNameOffset() })
 	{
-		if (token.type == TokenType::IDENTIFIER && token.value == node.getIdentifier()
-			&& token.line == line
-			&& col >= token.column
-			&& col < token.column + token.value.size())
+		if (!source || offset == UINT32_MAX || source->text().substr(offset, nameSize) != node.getIdentifier())
+			continue;
+
+		// Whole identifier only, not a longer one starting with the name
+		char next = offset + nameSize < source->text().size() ? source->text()[offset + nameSize] : '\0';
+		if (std::isalnum(static_cast<unsigned char>(next)) || next == '_' || next == '-')
+			continue;
+
+		auto [tokLine, tokColumn] = source->position(offset);
+		if (tokLine == line
+			&& col >= tokColumn
+			&& col < tokColumn + nameSize)
 		{
 			return formatTagHover(schema);
 		}
@@ -194,37 +211,43 @@ std::string SceneLanguageService::find_hover_recursive(const Node& node, const T
 
 	for (const auto& [attrName, attrInfo] : node.getAttributes())
 	{
-		if (attrInfo.attr_line == line
-			&& col >= attrInfo.attr_column
-			&& col < attrInfo.attr_column + attrName.size())
+		auto [attrLine, attrColumn] = node.getPosition(attrInfo.attr_offset);
+		auto [contentLine, contentColumn] = node.getPosition(attrInfo.content_offset);
+
+		if (attrLine == line
+			&& col >= attrColumn
+			&& col < attrColumn + node.nameOf(attrName).size())
 		{
-			auto attrIt = schema.attributes.find(attrName);
-			if (attrIt == schema.attributes.end()) return "";
+			// An attribute named like its tag hovers as the tag
+			if (attrName == node.getSymbol()) return formatTagHover(schema);
+
+			const AttributeSchema *attrSchema = schema.findAttribute(attrName);
+			if (!attrSchema) return "";
 
-			return formatAttributeHover(attrIt->second, node.getIdentifier());
+			return formatAttributeHover(*attrSchema, node.getIdentifier());
 		}
 
-		if (attrInfo.content_line != UINT64_MAX
-			&& attrInfo.content_line == line
-			&& col >= attrInfo.content_column - 1
-			&& col < attrInfo.content_column + attrInfo.content.size() + 1)
+		if (contentLine != UINT64_MAX
+			&& contentLine == line
+			&& col >= contentColumn - 1
+			&& col < contentColumn + attrInfo.content.size() + 1)
 		{
-			auto attrIt = schema.attributes.find(attrName);
-			if (attrIt == schema.attributes.end()) return "";
+			const AttributeSchema *attrSchema = schema.findAttribute(attrName);
+			if (!attrSchema) return "";
 
-			return formatAttributeHover(attrIt->second, node.getIdentifier());
+			return formatAttributeHover(*attrSchema, node.getIdentifier());
 		}
 	}
 
 	for (const auto& child : node.getChildren())
 	{
-		auto tagSchema = schema.children.find(child.getIdentifier());
+		const TagSchema *tagSchema = schema.findChild(child.getSymbol());
 
-		if (tagSchema == schema.children.end()) continue;
+		if (!tagSchema) continue;
 
-		auto sch = buildEffectiveSchema(tagSchema->second, child);
+		const TagSchema *sch = buildEffectiveSchema(*tagSchema, child);
 
-		std::string result = find_hover_recursive(child, sch, line, col);
+		std::string result = find_hover_recursive(child, *sch, line, col);
 		if (!result.empty())
 			return result;
 	}
@@ -236,13 +259,13 @@ std::string SceneLanguageService::get_hover(const Node& ast, const SceneSchema&
 {
 	for (const auto& child : ast.getChildren())
 	{
-		auto tagSchema = schema.root.children.find(child.getIdentifier());
+		const TagSchema *tagSchema = schema.getRoot().findChild(child.getSymbol());
 
-		if (tagSchema == schema.root.children.end()) continue;
+		if (!tagSchema) continue;
 
-		auto sch = buildEffectiveSchema(tagSchema->second, child);
+		const TagSchema *sch = buildEffectiveSchema(*tagSchema, child);
 
-		std::string result = find_hover_recursive(child, sch, line, col);
+		std::string result = find_hover_recursive(child, *sch, line, col);
 		if (!result.empty())
 			return result;
 	}
@@ -7,15 +7,19 @@
 namespace sceneIO::tdr {
 
 struct ParseResult {
-	Node ast;
+	Ast ast;
 	std::vector<TdrError> errors;
+	std::shared_ptr<TokenSource> source;	// keeps the token values of ast alive
 };
 
 class SceneLanguageService
 {
 public:
-	static ParseResult parse_file(const std::string& filepath);
-	static ParseResult parse_content(const std::string& content, const std::string& filePath = "");
+	// Files are checked against @p schema, the shared default one unless given
+	static ParseResult parse_file(const std::string& filepath, const SceneSchema& schema = SceneSchema::instance());
+	static ParseResult parse_content(const std::string& content, const std::string& filePath = "", const SceneSchema& schema = SceneSchema::instance());
+	// Same, reusing the storage of the previous parses made with @p context
+	static ParseResult parse_content(const std::string& content, const std::string& filePath, ParseContext& context, const SceneSchema& schema = SceneSchema::instance());
 	
 	// std::vector<CompletionItem> get_completions(const std::string& content, int line, int col); // my dream
 	static std::string get_hover(const Node& ast, const SceneSchema& schema, size_t line, size_t col);
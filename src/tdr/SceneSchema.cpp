@@ -1,6 +1,5 @@
 #include "tdr/SceneSchema.hpp"
-#include <iostream>
-#include <math.h>
+#include "tdr/schemaLookup.hpp"
 
 namespace sceneIO::tdr {
 
@@ -21,21 +20,103 @@ const std::string printValueType(ValueType type)
 	return "";
 }
 
-void TagSchema::include(const std::map<std::string, TagSchema>& group)
+namespace {
+
+std::optional<std::pair<float, float>> makeRange(bool hasRange, float min, float max)
+{
+	if (!hasRange) return std::nullopt;
+	return std::make_pair(min, max);
+}
+
+std::span<const std::string_view> makeStrings(schema::Range range)
+{
+	return std::span(schema::strings).subspan(range.begin, range.count);
+}
+
+}
+
+std::optional<std::string_view> AttributeSchema::defaultValue() const
+{
+	if (!has_default) return std::nullopt;
+	return default_text;
+}
+
+std::optional<std::pair<float, float>> AttributeSchema::range() const
+{
+	return makeRange(has_range, range_min, range_max);
+}
+
+std::span<const std::string_view> AttributeSchema::enumValues() const
+{
+	return makeStrings(enum_list);
+}
+
+std::span<const std::string_view> AttributeSchema::examples() const
+{
+	return makeStrings(example_list);
+}
+
+const TagSchema& ConditionalVariant::effective() const
+{
+	return schema::tags[tag];
+}
+
+std::optional<ValueType> TagSchema::textType() const
+{
+	if (!has_text_type) return std::nullopt;
+	return text_type;
+}
+
+std::optional<std::pair<float, float>> TagSchema::range() const
+{
+	return makeRange(has_range, range_min, range_max);
+}
+
+std::span<const std::string_view> TagSchema::enumValues() const
+{
+	return makeStrings(enum_list);
+}
+
+std::span<const std::string_view> TagSchema::examples() const
+{
+	return makeStrings(example_list);
+}
+
+RecordList<AttributeSchema> TagSchema::attributes() const
+{
+	return RecordList<AttributeSchema>(std::span(schema::attributeLists).subspan(attribute_list.begin, attribute_list.count), schema::attributes.data());
+}
+
+RecordList<TagSchema> TagSchema::children() const
+{
+	return RecordList<TagSchema>(std::span(schema::tagLists).subspan(child_list.begin, child_list.count), schema::tags.data());
+}
+
+std::span<const ConditionalVariant> TagSchema::variants() const
 {
-	for (const auto& [name, tag] : group)
-		children[name] = tag;
+	return std::span(schema::variants).subspan(variant_list.begin, variant_list.count);
 }
 
-void ConditionalVariant::include(const std::map<std::string, TagSchema>& group)
+const ConditionalVariant *TagSchema::fromCondition() const
 {
-	for (const auto& [name, tag] : group)
-		children[name] = tag;
+	return condition == schema::noRecord ? nullptr : &schema::variants[condition];
 }
 
-const ConditionalVariant* TagSchema::getMatchingVariant(const std::string& discriminator_value) const
+const TagSchema *TagSchema::findChild(Symbol key) const
 {
-	for (const auto& variant : variants)
+	uint16_t index = schema::findChild(schema::indexOf(*this), key);
+	return index == schema::noRecord ? nullptr : &schema::tags[index];
+}
+
+const AttributeSchema *TagSchema::findAttribute(Symbol key) const
+{
+	uint16_t index = schema::findAttribute(schema::indexOf(*this), key);
+	return index == schema::noRecord ? nullptr : &schema::attributes[index];
+}
+
+const ConditionalVariant* TagSchema::getMatchingVariant(std::string_view discriminator_value) const
+{
+	for (const auto& variant : variants())
 	{
 		if (variant.discriminator_value == discriminator_value)
 			return &variant;
@@ -43,36 +124,44 @@ const ConditionalVariant* TagSchema::getMatchingVariant(const std::string& discr
 	return nullptr;
 }
 
-const TagSchema *SceneSchema::findTagRecursive(const TagSchema& tag, const std::string& tagName) const
+const TagSchema& SceneSchema::getRoot() const
+{
+	return schema::tags[schema::rootTag];
+}
+
+const SceneSchema& SceneSchema::instance()
 {
-	if (tag.name == tagName)
+	static const SceneSchema schema;
+	return schema;
+}
+
+const TagSchema *SceneSchema::findTagRecursive(const TagSchema& tag, Symbol tagName) const
+{
+	if (Symbol::find(tag.name) == tagName)
 		return &tag;
 	else
 	{
-		for (auto it = tag.children.begin(); it != tag.children.end(); it++)
+		for (const TagSchema& child : tag.children())
 		{
-			auto res = findTagRecursive(it->second, tagName);
+			auto res = findTagRecursive(child, tagName);
 			if (res) return res;
 		}
 	}
 	return nullptr;
 }
 
-const TagSchema *SceneSchema::getTagSchema(const std::string& tagName) const
+const TagSchema *SceneSchema::getTagSchema(Symbol tagName) const
 {
-	return findTagRecursive(root, tagName);
+	return findTagRecursive(getRoot(), tagName);
 }
 
-const AttributeSchema *SceneSchema::getAttributeSchema(const std::string& tagName, const std::string& attrName) const
+const AttributeSchema *SceneSchema::getAttributeSchema(Symbol tagName, Symbol attrName) const
 {
 	const TagSchema *tag = getTagSchema(tagName);
 
 	if (!tag) return nullptr;
 
-	for (auto it = tag->attributes.begin(); it != tag->attributes.end(); it++)
-		if (it->first == attrName) return &it->second;
-
-	return nullptr;
+	return tag->findAttribute(attrName);
 }
 
 }
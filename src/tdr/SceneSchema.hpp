@@ -1,10 +1,13 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <iterator>
 #include <optional>
-#include <map>
-#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "tdr/symbols.hpp"
 
 namespace sceneIO::tdr {
 
@@ -22,93 +25,165 @@ enum class ValueType
 
 const std::string printValueType(ValueType type);
 
-struct AttributeSchema
+namespace schema {
+
+// Records [begin, begin + count) of a table of schemaData.hpp
+struct Range
 {
-	std::string name;
-	bool required;
-	ValueType type;
-	std::optional<std::string> default_value;
+	uint16_t begin;
+	uint16_t count;
+};
 
-	std::optional<std::pair<float, float>> range;	// INT/FLOAT/VEC
-	std::vector<std::string> enum_values;			// ENUM
+}
 
-	std::string hover_info;
-	std::string completion_detail;
+/**
+ * Records of a list of the schema tables, iterated as references: the
+ * list holds their indices in the table.
+ */
+template <typename Record>
+class RecordList
+{
+public:
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Record;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Record*;
+		using reference = const Record&;
+
+		iterator() = default;
+		iterator(const uint16_t *index, const Record *records) : index_(index), records_(records) {}
+
+		const Record& operator*() const { return records_[*index_]; }
+		const Record *operator->() const { return &records_[*index_]; }
+		iterator& operator++() { index_++; return *this; }
+		iterator operator++(int) { iterator res = *this; index_++; return res; }
+		bool operator==(const iterator& other) const { return index_ == other.index_; }
+
+	private:
+		const uint16_t *index_ = nullptr;
+		const Record *records_ = nullptr;
+	};
+
+	RecordList(std::span<const uint16_t> indices, const Record *records) : indices_(indices), records_(records) {}
+
+	iterator begin() const { return iterator(indices_.data(), records_); }
+	iterator end() const { return iterator(indices_.data() + indices_.size(), records_); }
+	size_t size() const { return indices_.size(); }
+	bool empty() const { return indices_.empty(); }
+	const Record& operator[](size_t i) const { return records_[indices_[i]]; }
+
+private:
+	std::span<const uint16_t> indices_;
+	const Record *records_;
+};
 
-	std::vector<std::string> examples;
+/**
+ * The schema types are the records of the constexpr tables generated from
+ * schema.json at build time (schemaData.hpp, see schemaTables.hpp): they are
+ * read in place, lists being ranges of those tables. Use the accessors, the
+ * fields are laid out for the generator.
+ */
+struct AttributeSchema
+{
+	Symbol key;						// in the attributes of its tag
+	std::string_view name;
+	bool required;
+	ValueType type;
+	bool has_default;
+	std::string_view default_text;
+	bool has_range;
+	float range_min;
+	float range_max;
+	schema::Range enum_list;		// in strings
+	std::string_view hover_info;
+	std::string_view completion_detail;
+	schema::Range example_list;		// in strings
+
+	std::optional<std::string_view> defaultValue() const;
+	std::optional<std::pair<float, float>> range() const;	// INT/FLOAT/VEC
+	std::span<const std::string_view> enumValues() const;	// ENUM
+	std::span<const std::string_view> examples() const;
 };
 
 struct TagSchema;
 
 struct ConditionalVariant
 {
-	std::string discriminator_attr;
-	std::string discriminator_value;
-
-	std::map<std::string, AttributeSchema> attributes;
-	std::map<std::string, TagSchema> children;
-
-	bool allow_text = false;
-	std::optional<ValueType> text_type;
-	
-	std::optional<std::pair<float, float>> range;	// INT/FLOAT/VEC
-	std::vector<std::string> enum_values;			// ENUM
-
-	std::string hover_info;
+	Symbol discriminator_attr;
+	std::string_view discriminator_value;
+	std::string_view hover_info;
+	uint16_t tag;					// in tags, the variant merged into its tag
 
-	void include(const std::map<std::string, TagSchema>& group);
+	// The tag with this variant merged in: its attributes and children added, its text, range and enum values
+	const TagSchema& effective() const;
 };
 
 struct TagSchema
 {
-	std::string name;
+	Symbol key;						// in the children of its parent
+	std::string_view name;
 	bool required;
 	bool allow_text;
-	std::optional<ValueType> text_type;
+	bool has_text_type;
+	ValueType text_type;
+	bool has_range;
+	float range_min;
+	float range_max;
+	schema::Range enum_list;		// in strings
+	std::string_view hover_info;
+	std::string_view completion_detail;
+	schema::Range example_list;		// in strings
+	bool allow_multiple;
+	schema::Range attribute_list;	// in attributeLists, sorted by key
+	schema::Range child_list;		// in tagLists, sorted by key, includes applied
+	schema::Range variant_list;		// in variants
+	uint16_t condition;				// in variants, the one merged into this tag if any
 
-	std::optional<std::pair<float, float>> range;	// INT/FLOAT/VEC
-	std::vector<std::string> enum_values;			// ENUM
+	std::optional<ValueType> textType() const;
+	std::optional<std::pair<float, float>> range() const;	// INT/FLOAT/VEC
+	std::span<const std::string_view> enumValues() const;	// ENUM
+	std::span<const std::string_view> examples() const;
 
-	std::map<std::string, AttributeSchema> attributes;
-	std::map<std::string, TagSchema> children;
-	
-	std::string hover_info;
-	std::string completion_detail;
-	std::vector<std::string> examples;
+	RecordList<AttributeSchema> attributes() const;
+	RecordList<TagSchema> children() const;
+	std::span<const ConditionalVariant> variants() const;
 
-	bool allow_multiple;
+	// Variant merged into this tag, nullptr for the tags as written
+	const ConditionalVariant *fromCondition() const;
 
-	std::vector<ConditionalVariant> variants;
-	std::optional<std::pair<std::string, std::string> > fromCondition;
+	// Through the perfect hashes of schemaData.hpp, nullptr if there is none
+	const TagSchema *findChild(Symbol key) const;
+	const AttributeSchema *findAttribute(Symbol key) const;
 
-	void include(const std::map<std::string, TagSchema>& group);
-	const ConditionalVariant* getMatchingVariant(const std::string& discriminator_value) const;
+	const ConditionalVariant *getMatchingVariant(std::string_view discriminator_value) const;
 };
 
+/**
+ * Read-only view of the schema generated from schema.json: nothing is
+ * built at runtime, every instance reads the same constexpr tables.
+ */
 class SceneSchema
 {
 
 private:
-	void build_schema();
-	void build_tag_groups();
-
-	const TagSchema *findTagRecursive(const TagSchema& tag, const std::string& tag_name) const;
+	const TagSchema *findTagRecursive(const TagSchema& tag, Symbol tag_name) const;
 
 public:
-	TagSchema root;
-
-	std::map<std::string, std::map<std::string, TagSchema>> tag_groups;
-	
-	SceneSchema()
-	{
-		build_tag_groups();
-		build_schema();
-	}
+	SceneSchema() = default;
 	~SceneSchema() = default;
 
-	const TagSchema *getTagSchema(const std::string& tag_name) const;
-	const AttributeSchema *getAttributeSchema(const std::string& tag_name, const std::string& attr_name) const;
+	// Top level tags are its children
+	const TagSchema& getRoot() const;
+
+	// The default schema, shared by every thread
+	static const SceneSchema& instance();
+
+	const TagSchema *getTagSchema(Symbol tag_name) const;
+	const AttributeSchema *getAttributeSchema(Symbol tag_name, Symbol attr_name) const;
 
 };
 
-}
\ No newline at end of file
+}
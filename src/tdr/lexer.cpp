@@ -3,76 +3,333 @@
 #include "colors.hpp"
 
 #include <algorithm> 
+#include <bit>
 #include <cctype>
+#include <cstdint>
 #include <locale>
 #include <iomanip>
 
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define TDR_LEXER_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define TDR_LEXER_HAS_SSE2 1
+#endif
+
 namespace sceneIO::tdr {
 
-std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
+/**
+ * First byte of [p, end) equal to @p a, @p b, @p c or @p d (repeat a byte
+ * to look for less), @p end if none.
+ */
+static const char *find_first_of(const char *p, const char *end, char a, char b, char c, char d)
 {
-	std::vector<Token> tokens;
+#ifdef TDR_LEXER_HAS_AVX2
+	const __m256i wa = _mm256_set1_epi8(a);
+	const __m256i wb = _mm256_set1_epi8(b);
+	const __m256i wc = _mm256_set1_epi8(c);
+	const __m256i wd = _mm256_set1_epi8(d);
+
+	for (; end - p >= 32; p += 32)
+	{
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+		__m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, wa), _mm256_cmpeq_epi8(v, wb)),
+		                              _mm256_or_si256(_mm256_cmpeq_epi8(v, wc), _mm256_cmpeq_epi8(v, wd)));
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+		if (mask) return p + std::countr_zero(mask);
+	}
+#endif
+#ifdef TDR_LEXER_HAS_SSE2
+	const __m128i va = _mm_set1_epi8(a);
+	const __m128i vb = _mm_set1_epi8(b);
+	const __m128i vc = _mm_set1_epi8(c);
+	const __m128i vd = _mm_set1_epi8(d);
+
+	for (; end - p >= 16; p += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+		                           _mm_or_si128(_mm_cmpeq_epi8(v, vc), _mm_cmpeq_epi8(v, vd)));
+		uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+		if (mask) return p + std::countr_zero(mask);
+	}
+#endif
+	for (; p < end; p++)
+		if (*p == a || *p == b || *p == c || *p == d) return p;
+	return end;
+}
+
+/**
+ * First byte of [p, end) that is not white space (as std::isspace in the
+ * "C" locale), @p end if none.
+ */
+static const char *skip_spaces(const char *p, const char *end)
+{
+#ifdef TDR_LEXER_HAS_SSE2
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab   = _mm_set1_epi8('\t');
+	const __m128i four  = _mm_set1_epi8(4);
+
+	for (; end - p >= 16; p += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+		// '\t' to '\r' are contiguous: v - '\t' <= 4 as unsigned bytes
+		__m128i control = _mm_sub_epi8(v, tab);
+		__m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(control, four), control);
+		__m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(v, space), is_control);
+
+		uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(is_space)) & 0xFFFFu;
+		if (mask) return p + std::countr_zero(mask);
+	}
+#endif
+	for (; p < end; p++)
+		if (*p != ' ' && (static_cast<unsigned char>(*p - '\t') > 4)) return p;
+	return end;
+}
+
+/**
+ * Appends the offset following every '\n' of @p text to @p starts.
+ */
+static void index_line_starts(std::string_view text, std::vector<uint32_t>& starts)
+{
+	const char *begin = text.data();
+	const char *p = begin;
+	const char *end = begin + text.size();
+
+#ifdef TDR_LEXER_HAS_SSE2
+	const __m128i nl = _mm_set1_epi8('\n');
+
+	for (; end - p >= 16; p += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+
+		for (; mask; mask &= mask - 1)
+			starts.push_back(static_cast<uint32_t>(p - begin + std::countr_zero(mask) + 1));
+	}
+#endif
+	for (; p < end; p++)
+		if (*p == '\n') starts.push_back(static_cast<uint32_t>(p - begin + 1));
+}
+
+std::shared_ptr<TokenSource> TokenSource::fromFile(const std::string& path)
+{
+	std::shared_ptr<TokenSource> source(new TokenSource());
+
+	if (!source->file_.open(path)) return nullptr;
+	source->text_ = source->file_.view();
+	return source;
+}
+
+std::shared_ptr<TokenSource> TokenSource::fromString(std::string content)
+{
+	std::shared_ptr<TokenSource> source(new TokenSource());
+
+	source->content_ = std::move(content);
+	source->text_ = source->content_;
+	return source;
+}
+
+void TokenSource::reset(std::string_view content)
+{
+	file_ = MappedFile();
+	content_.assign(content);
+	text_ = content_;
+	rebuilt_.clear();
+	symbols_.clear();
+
+	lineStarts_.clear();
+	linesIndexed_.store(false, std::memory_order_relaxed);
+}
+
+std::pair<uint64_t, uint64_t> TokenSource::position(uint32_t offset) const
+{
+	if (!linesIndexed_.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(linesMutex_);
+		if (!linesIndexed_.load(std::memory_order_relaxed))
+		{
+			lineStarts_.push_back(0);
+			index_line_starts(text_, lineStarts_);
+			linesIndexed_.store(true, std::memory_order_release);
+		}
+	}
+
+	auto next = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset);
+	size_t line = static_cast<size_t>(next - lineStarts_.begin());
+
+	return { line, offset - lineStarts_[line - 1] + 1 };
+}
+
+TokenStream::TokenStream(TokenSource& source, ErrorCollector& errors, uint32_t from, std::vector<std::string> *kept)
+	: source_(source), errors_(errors), kept_(kept)
+{
+	const std::string_view src = source.text();
+
+	if (src.size() >= UINT32_MAX) throw TdrError("Sources larger than 4 GiB are not supported");
+
+	begin_ = src.data();
+	cur_ = begin_ + std::min<size_t>(from, src.size());
+	end_ = begin_ + src.size();
+
+	current_ = lex();
+}
+
+TokenStream::TokenStream(TokenSource& source, std::span<const Token> tokens, ErrorCollector& errors)
+	: source_(source), errors_(errors), replay_(tokens)
+{
+	if (tokens.empty() || tokens.back().type != TokenType::END_OF_FILE)
+		throw TdrError("Internal TDR lexer error: replayed tokens must end with END_OF_FILE");
+
+	begin_ = cur_ = end_ = source.text().data();
+
+	current_ = lex();
+}
+
+uint32_t TokenStream::keep(std::string value)
+{
+	if (!kept_) return source_.keep(std::move(value));
+
+	kept_->push_back(std::move(value));
+	return static_cast<uint32_t>(kept_->size() - 1);
+}
+
+Token TokenStream::advance()
+{
+	Token tok = current_;
+
+	previous_ = current_;
+	hasPrevious_ = true;
+
+	if (hasPushedBack_)
+	{
+		current_ = pushedBack_;
+		hasPushedBack_ = false;
+	}
+	else current_ = lex();
+
+	return tok;
+}
+
+void TokenStream::back()
+{
+	if (!hasPrevious_) throw TdrError("Internal TDR parser error: cursor underflow protection");
+
+	pushedBack_ = current_;
+	hasPushedBack_ = true;
+	current_ = previous_;
+	hasPrevious_ = false;
+}
+
+Token TokenStream::lex()
+{
+	if (!replay_.empty())
+		return replayed_ < replay_.size() ? replay_[replayed_++] : replay_.back();
+
+	TokenSource& source = source_;
+	ErrorCollector& errors = errors_;
+
+	char c = '\0';
+
+	const char *const begin = begin_;
+	const char *&cur = cur_;
+	const char *const end = end_;
+
+	auto offset_of = [&](const char *p) -> uint32_t
+	{
+		return static_cast<uint32_t>(p - begin);
+	};
+
+	// Line and column of the cursor, only resolved for diagnostics
+	auto here = [&]() -> std::pair<uint64_t, uint64_t>
+	{
+		return source.position(offset_of(cur));
+	};
+
+	auto error = [&](const std::string& msg)
+	{
+		auto [line, column] = here();
+		errors.report(TdrError(line, column, msg));
+	};
+
+	auto make = [&](TokenType type, const char *start, size_t length = 0) -> Token
+	{
+		return {type, false, offset_of(start), static_cast<uint32_t>(length)};
+	};
+
+	auto make_rebuilt = [&](TokenType type, const char *start, std::string value) -> Token
+	{
+		return {type, true, offset_of(start), keep(std::move(value))};
+	};
 
-	uint64_t line = 1;
-	uint64_t column = 1;
-	char c;
-	
 	auto peek = [&]() -> char
 	{
-		int next = in.peek();
-		return (next == EOF) ? '\0' : static_cast<char>(next);
+		return (cur < end) ? *cur : '\0';
 	};
 
 	auto peek_next = [&]() -> char
 	{
-		char current = in.get();
-		if (current == EOF) return '\0';
-
-		int next = in.peek();
-		in.unget();
-		
-		return (next == EOF) ? '\0' : static_cast<char>(next);
+		return (cur + 1 < end) ? cur[1] : '\0';
 	};
 	
 	auto advance = [&]() -> char
 	{
-		if (!in.get(c)) return '\0';
-		if (c == '\n')
-		{
-			line++;
-			column = 1;
-		}
-		else column++;
+		if (cur >= end) return '\0';
+		c = *cur++;
 		return c;
 	};
 	
+
+	auto is_space = [](char ch) -> bool
+	{
+		return std::isspace(static_cast<unsigned char>(ch));
+	};
+
 	auto skip_whitespace_in_tag = [&]()
 	{
-		while (std::isspace(peek()) && peek() != '\0') advance();
+		cur = skip_spaces(cur, end);
 	};
 	
 	auto skip_comment = [&]()
 	{
 		if (peek() == '/' && peek_next() == '/')
-			while (peek() != '\n' && peek() != '\0')
-				advance();
+			cur = find_first_of(cur, end, '\n', '\0', '\n', '\n');
 	};
 	
-	auto read_identifier = [&](uint64_t start_line, uint64_t start_col) -> Token
+	auto read_identifier = [&]() -> Token
 	{
-		std::string value;
+		const char *start = cur;
 
-		while (std::isalnum(peek()) || peek() == '_' || peek() == '-')
-			value += advance();
+		while (cur < end && (std::isalnum(static_cast<unsigned char>(*cur)) || *cur == '_' || *cur == '-'))
+			cur++;
 
-		return {TokenType::IDENTIFIER, value, start_line, start_col};
+		return make(TokenType::IDENTIFIER, start, static_cast<size_t>(cur - start));
 	};
 	
-	auto read_string = [&](uint64_t start_line, uint64_t start_col) -> Token
+	auto read_string = [&]() -> Token
 	{
-		std::string value;
 		char quote = c;
-		
+		const char *open = cur - 1;
+		const char *start = cur;
+
+		// Fast path: the literal is a plain run of the source
+		cur = find_first_of(cur, end, quote, '\\', '\n', '\0');
+
+		std::string_view run(start, static_cast<size_t>(cur - start));
+
+		if (peek() == quote)
+		{
+			advance();
+			return make(TokenType::STRING, open, run.size());
+		}
+
+		// Slow path: escapes (or an error) ahead, the value is rebuilt
+		std::string value(run);
+		bool escaped = false;
+
 		while (true)
 		{
 			if (peek() == quote)
@@ -82,12 +339,12 @@ std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
 			}
 			else if (peek() == '\0')
 			{
-				errors.report(TdrError(line, column, "Unterminated string literal"));
+				error("Unterminated string literal");
 				break;
 			}
 			else if (peek() == '\n')
 			{
-				errors.report(TdrError(line, column, "Newline in string literal"));
+				error("Newline in string literal");
 				break;
 			}
 
@@ -96,10 +353,11 @@ std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
 			{
 				if (peek() == '\0')
 				{
-					errors.report(TdrError(line, column, "Unterminated escape sequence"));
+					error("Unterminated escape sequence");
 					break;
 				}
 
+				escaped = true;
 				advance();
 				switch (c)
 				{
@@ -113,51 +371,91 @@ std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
 			}
 			else value += c;
 		}
-		
-		return {TokenType::STRING, value, start_line, start_col};
+
+		if (!escaped)
+			return make(TokenType::STRING, open, value.size());
+		return make_rebuilt(TokenType::STRING, open, std::move(value));
 	};
 	
-	auto read_text = [&](uint64_t start_line, uint64_t start_col) -> Token
+	auto read_text = [&]() -> Token
 	{
-		std::string value;
-		
-		while (peek() != '<' && peek() != '\0')
+		static constexpr std::string_view blanks = " \t\n\r";
+
+		auto trim = [](std::string_view text) -> std::string_view
 		{
-			if (peek() == '/')
+			size_t first = text.find_first_not_of(blanks);
+			if (first == std::string_view::npos) return {};
+			return text.substr(first, text.find_last_not_of(blanks) - first + 1);
+		};
+
+		// Comments split the text in runs; it stays a view of the source as
+		// long as a single run holds non blank characters
+		const char *text_start = cur;
+		const char *segment = cur;
+		std::string_view content;
+		size_t filled_runs = 0;
+
+		auto end_run = [&]()
+		{
+			std::string_view run(segment, static_cast<size_t>(cur - segment));
+			if (run.find_first_not_of(blanks) != std::string_view::npos)
 			{
-				if (peek_next() == '/')
-				{
-					skip_comment();
-					continue;
-				}
+				content = run;
+				filled_runs++;
+			}
+		};
+
+		while (true)
+		{
+			cur = find_first_of(cur, end, '<', '/', '\0', '<');
+			if (peek() != '/') break;
+
+			if (peek_next() == '/')
+			{
+				end_run();
+				skip_comment();
+				segment = cur;
+				continue;
 			}
 			advance();
-			value += c;
 		}
-		
-		size_t start = value.find_first_not_of(" \t\n\r");
-		size_t end = value.find_last_not_of(" \t\n\r");
-		
-		if (start == std::string::npos) value = "";
-		else value = value.substr(start, end - start + 1);
-		
-		return {TokenType::TEXT, value, start_line, start_col};
+		end_run();
+
+		// A single run starts the text: white space before it is skipped by the caller
+		std::string_view trimmed = trim(content);
+		if (filled_runs <= 1 && (trimmed.empty() || trimmed.data() == text_start))
+			return make(TokenType::TEXT, text_start, trimmed.size());
+
+		std::string value;
+		for (const char *p = text_start; p < cur; p++)
+		{
+			if (p[0] == '/' && p + 1 < cur && p[1] == '/')
+				while (p + 1 < cur && p[1] != '\n') p++;
+			else value += *p;
+		}
+
+		return make_rebuilt(TokenType::TEXT, text_start, std::string(trim(value)));
 	};
 	
-	bool inside_tag = false;
-	
+	bool& inside_tag = insideTag_;
+
+	if (tagNamePending_)
+	{
+		tagNamePending_ = false;
+		return read_identifier();
+	}
+
 	while (peek() != '\0')
 	{
 		skip_comment();
 		
-		if (!inside_tag && std::isspace(peek()))
+		if (!inside_tag && is_space(peek()))
 		{
-			advance();
+			skip_whitespace_in_tag();
 			continue;
 		}
 		
-		uint64_t start_line = line;
-		uint64_t start_col = column;
+		const char *start = cur;
 		
 		if (peek() == '<')
 		{
@@ -168,29 +466,29 @@ std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
 				advance();
 				skip_whitespace_in_tag();
 				
-				if (!std::isalpha(peek())) errors.report(TdrError(line, column, "Expected valid tag name after '</'"));
+				if (!std::isalpha(static_cast<unsigned char>(peek()))) error("Expected valid tag name after '</'");
 				
-				tokens.push_back({TokenType::TAG_END_OPEN, "", start_line, start_col});
-				tokens.push_back(read_identifier(line, column));
+				tagNamePending_ = true;
 				inside_tag = true;
+				return make(TokenType::TAG_END_OPEN, start);
 				
 			}
 			else
 			{
 				skip_whitespace_in_tag();
 
-				if (!std::isalpha(peek())) errors.report(TdrError(line, column, "Expected valid tag name after '<'"));
+				if (!std::isalpha(static_cast<unsigned char>(peek()))) error("Expected valid tag name after '<'");
 	
-				tokens.push_back({TokenType::TAG_OPEN, "", start_line, start_col});
-				tokens.push_back(read_identifier(line, column));
+				tagNamePending_ = true;
 				inside_tag = true;
+				return make(TokenType::TAG_OPEN, start);
 			}
 		}
 		else if (inside_tag && peek() == '>')
 		{
 			advance();
-			tokens.push_back({TokenType::TAG_CLOSE, "", start_line, start_col});
 			inside_tag = false;
+			return make(TokenType::TAG_CLOSE, start);
 		}
 		else if (inside_tag && peek() == '/')
 		{
@@ -198,70 +496,84 @@ std::vector<Token> lexer(std::istream& in, ErrorCollector& errors)
 			if (peek() == '>')
 			{
 				advance();
-				tokens.push_back({TokenType::TAG_SELF_CLOSE, "", start_line, start_col});
 				inside_tag = false;
+				return make(TokenType::TAG_SELF_CLOSE, start);
 			}
 			else
 			{
-				tokens.push_back({TokenType::TAG_SELF_CLOSE, "", start_line, start_col});
 				inside_tag = false;
-				errors.report(TdrError(line, column, "Expected '>' after '/'"));
+				error("Expected '>' after '/'");
+				return make(TokenType::TAG_SELF_CLOSE, start);
 			}
 		}
 		else if (inside_tag && peek() == '=')
 		{
 			advance();
-			tokens.push_back({TokenType::EQUALS, "", start_line, start_col});
+			return make(TokenType::EQUALS, start);
 		}
 		else if (inside_tag && (peek() == '"' || peek() == '\''))
 		{
 			advance();
-			tokens.push_back(read_string(start_line, start_col));
+			return read_string();
 		}
-		else if (inside_tag && std::isalpha(peek()))
+		else if (inside_tag && std::isalpha(static_cast<unsigned char>(peek())))
 		{
-			tokens.push_back(read_identifier(line, column));
+			return read_identifier();
 		}
-		else if (inside_tag && std::isspace(peek()))
+		else if (inside_tag && is_space(peek()))
 		{
 			skip_whitespace_in_tag();
 		}
 		else if (!inside_tag && peek() != '\0')
 		{
-			Token text = read_text(start_line, start_col);
+			Token text = read_text();
 
-			if (!text.value.empty()) tokens.push_back(text);
+			if (text.rebuilt || text.length > 0) return text;
 		}
 		else
 		{
-			errors.report(TdrError(line, column, std::string("Unexpected character '") + peek() + "'"));
+			error(std::string("Unexpected character '") + peek() + "'");
 			advance();
 		}
 	}
-	tokens.push_back((Token){TokenType::END_OF_FILE, "", line, column});
+	return make(TokenType::END_OF_FILE, cur);
+}
+
+std::vector<Token> lexer(TokenSource& source, ErrorCollector& errors)
+{
+	TokenStream stream(source, errors);
+	std::vector<Token> tokens;
+
+	while (stream.peek().type != TokenType::END_OF_FILE)
+		tokens.push_back(stream.advance());
+
+	tokens.push_back(stream.peek());
 	return tokens;
 }
 
 
-void print_tokens(const std::vector<Token>& tokens)
+void print_tokens(const std::vector<Token>& tokens, const TokenSource& source)
 {
 	std::cout << STYLE_BOLD << COLOR_BRIGHT_CYAN << "=== TOKENS ===" << COLOR_RESET << std::endl;
 	
 	for (const Token& token : tokens)
 	{
+		auto [line, column] = source.position(token.offset);
+		std::string_view value = source.value(token);
+
 		std::cout << COLOR_BRIGHT_BLACK 
-				<< std::setw(4) << std::right << token.line 
+				<< std::setw(4) << std::right << line 
 				<< ":" 
-				<< std::setw(3) << std::left << token.column 
+				<< std::setw(3) << std::left << column 
 				<< COLOR_RESET;
 		
 		std::cout << " " << COLOR_YELLOW 
 				<< std::setw(16) << std::left << token.type 
 				<< COLOR_RESET;
 		
-		if (!token.value.empty()) {
+		if (!value.empty()) {
 			std::cout << " " << COLOR_GREEN 
-					<< "\"" << token.value << "\"" 
+					<< "\"" << value << "\"" 
 					<< COLOR_RESET;
 		}
 		
@@ -271,7 +583,7 @@ void print_tokens(const std::vector<Token>& tokens)
 	std::cout << STYLE_BOLD << COLOR_BRIGHT_CYAN  << "=== " << tokens.size() << " tokens ===" << COLOR_RESET << std::endl;
 }
 
-const std::string getTokenContent(Token& tok)
+const std::string getTokenContent(const Token& tok, const TokenSource& source)
 {
 	switch (tok.type)
 	{
@@ -281,9 +593,9 @@ const std::string getTokenContent(Token& tok)
 		case TokenType::TAG_SELF_CLOSE: return "/>";
 		case TokenType::EQUALS: return "=";
 		case TokenType::END_OF_FILE: return "End Of File";
-		case TokenType::IDENTIFIER: return "identifier: " + std::string("\"") + tok.value + std::string("\"");
-		case TokenType::STRING: return "string: " + std::string("\"") + tok.value + std::string("\"");
-		case TokenType::TEXT: return "text: " + std::string("\"") + tok.value + std::string("\"");
+		case TokenType::IDENTIFIER: return "identifier: " + std::string("\"") + std::string(source.value(tok)) + std::string("\"");
+		case TokenType::STRING: return "string: " + std::string("\"") + std::string(source.value(tok)) + std::string("\"");
+		case TokenType::TEXT: return "text: " + std::string("\"") + std::string(source.value(tok)) + std::string("\"");
 	}
 	return "";
 }
@@ -1,15 +1,24 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <fstream>
 #include <iostream>
 
 #include "tdr/error.hpp"
+#include "tdr/symbols.hpp"
+#include "mappedFile.hpp"
 
 namespace sceneIO::tdr {
 
-enum class TokenType {
+enum class TokenType : uint8_t {
 	TAG_OPEN,		// <
 	TAG_END_OPEN,	// </
 	TAG_CLOSE,		// >
@@ -21,18 +30,139 @@ enum class TokenType {
 	END_OF_FILE
 };
 
+/**
+ * 12 bytes: the value and the line/column are looked up in the TokenSource
+ * the token was read from (TokenSource::value / TokenSource::position).
+ */
 struct Token
 {
 	TokenType type = TokenType::TEXT;
-	std::string value;
-	uint64_t line;
-	uint64_t column;
+	bool rebuilt = false;		// value is not a slice of the source, length is its index in the source
+	uint32_t offset = 0;		// first byte of the token (the opening quote for strings)
+	uint32_t length = 0;		// bytes of the value
 };
 
-std::vector<Token> lexer(std::istream& in, ErrorCollector& errors);
-void print_tokens(const std::vector<Token>& tokens);
+/**
+ * Memory token values point into: the source text (a mapped file or an owned
+ * string) and the few values rebuilt because they contain escapes or
+ * comments. Must outlive the tokens and every Node holding copies of them.
+ * Line starts are indexed on the first position() call.
+ */
+class TokenSource : public std::enable_shared_from_this<TokenSource>
+{
+public:
+	static std::shared_ptr<TokenSource> fromFile(const std::string& path);	// nullptr if it cannot be read
+	static std::shared_ptr<TokenSource> fromString(std::string content);
+
+	TokenSource(const TokenSource&) = delete;
+	TokenSource& operator=(const TokenSource&) = delete;
+
+	// Replaces the text with a copy of @p content, reusing the buffers. No
+	// token or node of the previous text may be used afterwards.
+	void reset(std::string_view content);
+
+	std::string_view text() const { return text_; }
+
+	std::string_view value(const Token& tok) const
+	{
+		if (tok.rebuilt) return rebuilt_[tok.length];
+		return text_.substr(tok.offset + (tok.type == TokenType::STRING ? 1 : 0), tok.length);
+	}
+
+	// {line, column} of a byte offset, both starting at 1
+	std::pair<uint64_t, uint64_t> position(uint32_t offset) const;
+
+	size_t keptCount() const { return rebuilt_.size(); }
+
+	uint32_t keep(std::string value)
+	{
+		rebuilt_.push_back(std::move(value));
+		return static_cast<uint32_t>(rebuilt_.size() - 1);
+	}
+
+	// Names read from this source that are missing from the process wide symbol table
+	SymbolScope& symbols() const { return symbols_; }
+
+private:
+	TokenSource() = default;
+
+	MappedFile file_;
+	std::string content_;
+	std::string_view text_;
+	std::deque<std::string> rebuilt_;
+	mutable SymbolScope symbols_;
+
+	mutable std::mutex linesMutex_;
+	mutable std::atomic<bool> linesIndexed_ = false;
+	mutable std::vector<uint32_t> lineStarts_;
+};
+
+/**
+ * Pull lexer: reads the tokens of a TokenSource one at a time, as the parser
+ * asks for them, so no token array is ever built. Holds the current token,
+ * the one before it and a single token pushed back, which is all the
+ * lookahead the parser needs. Lexing errors are reported as the tokens are
+ * read. Once the end is reached, END_OF_FILE is returned forever.
+ */
+class TokenStream
+{
+public:
+	/**
+	 * Lexes @p source from the byte offset @p from. When @p kept is set,
+	 * rebuilt values are stored there rather than in the source, which lets
+	 * several streams lex one source on different threads.
+	 */
+	TokenStream(TokenSource& source, ErrorCollector& errors, uint32_t from = 0, std::vector<std::string> *kept = nullptr);
+
+	// Replays tokens lexed beforehand, the last of which is END_OF_FILE
+	TokenStream(TokenSource& source, std::span<const Token> tokens, ErrorCollector& errors);
+
+	TokenStream(const TokenStream&) = delete;
+	TokenStream& operator=(const TokenStream&) = delete;
+
+	const TokenSource& source() const { return source_; }
+
+	// Current token, not consumed yet
+	const Token& peek() const { return current_; }
+
+	// Last consumed token, the current one at the start or right after back()
+	const Token& last() const { return hasPrevious_ ? previous_ : current_; }
+
+	// Consumes the current token and returns it
+	Token advance();
+
+	// Makes the last consumed token current again, once per advance()
+	void back();
+
+private:
+	Token lex();
+	uint32_t keep(std::string value);
+
+	TokenSource& source_;
+	ErrorCollector& errors_;
+	std::vector<std::string> *kept_ = nullptr;
+
+	std::span<const Token> replay_;
+	size_t replayed_ = 0;
+
+	const char *begin_;
+	const char *cur_;
+	const char *end_;
+	bool insideTag_ = false;
+	bool tagNamePending_ = false;		// '<' or '</' was just read, the name comes next
+
+	Token current_;
+	Token previous_;
+	Token pushedBack_;
+	bool hasPrevious_ = false;
+	bool hasPushedBack_ = false;
+};
+
+// Reads the whole source at once, for tools and debugging
+std::vector<Token> lexer(TokenSource& source, ErrorCollector& errors);
+void print_tokens(const std::vector<Token>& tokens, const TokenSource& source);
 
-const std::string getTokenContent(Token& tok);
+const std::string getTokenContent(const Token& tok, const TokenSource& source);
 
 inline std::ostream& operator<<(std::ostream& io, TokenType token)
 {
@@ -1,90 +1,81 @@
 #include "tdr/LanguageService.hpp"
 #include "tdr/loadScene.hpp"
+#include "tdr/semanticAnalyzer.hpp"
 #include "objParser.hpp"
-
-#include <charconv>
+#include "gltfParser.hpp"
+#include "meshCleanup.hpp"
+#include "meshReorder.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 #include <vector>
 
 namespace sceneIO::tdr {
 
-std::vector<sceneIO::tdr::Node>::const_iterator SceneLoader::getChildElement(const Node& n, const std::string& name)
+std::span<const sceneIO::tdr::Node>::iterator SceneLoader::getChildElement(const Node& n, Symbol name)
 {
 	return find_if(	n.getChildren().begin(),
 					n.getChildren().end(),
-					[&](const Node& n) { return n.getIdentifier() == name; });
+					[&](const Node& n) { return n.getSymbol() == name; });
 }
 
-static float getColorChar(const std::string& s)
+// Values decoded by the semantic analyzer, which the scene only loads without errors
+
+static float getFloat(const TypedValue& v)
 {
-	int value = 0;
-	auto [ptr, ec] = std::from_chars(
-		s.data(),
-		s.data() + s.size(),
-		value
-	);
-	return value / 255.0f;
+	if (auto f = std::get_if<float>(&v)) return *f;
+	if (auto i = std::get_if<int>(&v)) return static_cast<float>(*i);
+	// A vec3 read as a float gives its first component, as parsing its text did
+	if (auto vec = std::get_if<std::array<float, 3>>(&v)) return (*vec)[0];
+	return 0.0f;
 }
 
-static float getFloat(const std::string& s)
+static int getInt(const TypedValue& v)
 {
-	float value = 0.0;
-	auto [ptr, ec] = std::from_chars(
-		s.data(),
-		s.data() + s.size(),
-		value
-	);
-	return value;
+	if (auto i = std::get_if<int>(&v)) return *i;
+	if (auto f = std::get_if<float>(&v)) return static_cast<int>(*f);
+	return 0;
 }
 
-static int getInt(const std::string& s)
+static bool getBool(const TypedValue& v)
 {
-	int value = 0.0;
-	auto [ptr, ec] = std::from_chars(
-		s.data(),
-		s.data() + s.size(),
-		value
-	);
-	return value;
+	auto b = std::get_if<bool>(&v);
+	return b && *b;
 }
 
-vec3 getColor(const std::string& s)
+vec3 getVec3(const TypedValue& v)
 {
-	if (s.empty()) return false;
-
-	if (s.size() == 7 && s[0] == '#')
-	{
-		int r = std::stoi(s.substr(1, 2), nullptr, 16);
-		int g = std::stoi(s.substr(3, 2), nullptr, 16);
-		int b = std::stoi(s.substr(5, 2), nullptr, 16);
-
-		return vec3(r / 255.0f, g / 255.0f, b / 255.0f);
-	}
-
-	std::vector<std::string> parts = cu::string::split(s, ',');
-	if (parts.size() == 3)
-		return vec3(getColorChar(parts[0]), getColorChar(parts[1]), getColorChar(parts[2]));
-	else
-	{
-		parts = cu::string::split(s, ' ');
-		if (parts.size() == 3)
-			return vec3(getFloat(parts[0]), getFloat(parts[1]), getFloat(parts[2]));
-	}
-	return vec3(0);
+	auto vec = std::get_if<std::array<float, 3>>(&v);
+	if (!vec) return vec3(0);
+	return vec3((*vec)[0], (*vec)[1], (*vec)[2]);
 }
 
-vec3 getVec3(const std::string& s)
+// Colors are decoded to rgb in [0, 1], whatever their notation
+vec3 getColor(const TypedValue& v)
 {
-	auto parts = cu::string::split(s, ' ');
-
-	return {getFloat(parts[0]), getFloat(parts[1]), getFloat(parts[1])};
+	return getVec3(v);
 }
 
-quat getQuat(const std::string& s)
+// Quaternions are written x y z w, their text is not checked by the schema
+quat getQuat(std::string_view s)
 {
-	throw std::runtime_error("J'ai eu la flemme d'implementer le parsing des quaternions donc je throw. A un moment je le gererai hein");
-	auto parts = cu::string::split(s, ' ');
-	return quat(getFloat(parts[3]), getFloat(parts[0]), getFloat(parts[1]), getFloat(parts[2]));
+	std::array<std::string_view, 4> parts;
+	std::array<float, 4> values = { 0, 0, 0, 0 };
+
+	bool valid = splitFields(s, ' ', parts) == 4;
+	for (size_t i = 0; valid && i < 4; i++)
+		valid = isValidValue(parts[i], values[i]);
+	if (!valid)
+		throw std::runtime_error("Invalid quaternion '" + std::string(s) + "', expected 'x y z w'.");
+
+	float norm = values[0] * values[0] + values[1] * values[1] + values[2] * values[2] + values[3] * values[3];
+	if (std::abs(norm - 1.0f) > 1e-3f)
+		throw std::runtime_error("Quaternion '" + std::string(s) + "' is not normalized.");
+
+	return quat(values[3], values[0], values[1], values[2]);
 }
 
 void SceneLoader::debugTextures() const
@@ -129,7 +120,7 @@ void SceneLoader::debugTextures() const
 
 void SceneLoader::loadTextures()
 {
-	auto it = getChildElement(ast_, "textures");
+	auto it = getChildElement(ast_, sym::textures);
 
 	if (it == ast_.getChildren().end()) return ;
 
@@ -138,43 +129,45 @@ void SceneLoader::loadTextures()
 	for (const Node& texture : textures.getChildren())
 	{
 		const auto& tex_attr = texture.getAttributes();
-		const AttributeInfos& name = tex_attr.find("name")->second;
-		if (scene_.textures_.find(name.content) != scene_.textures_.end())
+		const AttributeInfos& nameAttr = tex_attr.find(sym::name)->second;
+		const std::string name(nameAttr.content);
+		if (scene_.textures_.find(name) != scene_.textures_.end())
 		{
-			errors_.report(TdrError(name.content_line, name.content_column, 2, "Duplicated texture name, it will be ignored"));
+			auto pos = texture.getPosition(nameAttr.content_offset);
+			errors_.report(TdrError(pos.first, pos.second, 2, "Duplicated texture name, it will be ignored"));
 			continue;
 		}
 
-		Texture& tex = scene_.textures_[name.content];
+		Texture& tex = scene_.textures_[name];
 
-		tex.name = name.content;
+		tex.name = name;
 
-		auto label = tex_attr.find("label");
+		auto label = tex_attr.find(sym::label);
 		if (label != tex_attr.end()) tex.label = label->second.content;
 
-		const std::string& type = tex_attr.find("type")->second.content;
+		std::string_view type = tex_attr.find(sym::type)->second.content;
 
 		if (type == "filepath")
 		{
 			Texture::FromFile tmp = {};
 
-			tmp.path = getChildElement(texture, "path")->getText();
+			tmp.path = getChildElement(texture, sym::path)->getText();
 			tex.data = std::move(tmp);
 		}
 		else if (type == "checker_local")
 		{
 			Texture::CheckerLocal tmp = {};
-			tmp.odd = getColor(getChildElement(texture, "odd")->getText());
-			tmp.even = getColor(getChildElement(texture, "even")->getText());
-			tmp.scale = getFloat(getChildElement(texture, "scale")->getText());
+			tmp.odd = getColor(getChildElement(texture, sym::odd)->getTextValue());
+			tmp.even = getColor(getChildElement(texture, sym::even)->getTextValue());
+			tmp.scale = getFloat(getChildElement(texture, sym::scale)->getTextValue());
 			tex.data = std::move(tmp);
 		}
 		else if (type == "checker_global")
 		{
 			Texture::CheckerGlobal tmp = {};
-			tmp.odd = getColor(getChildElement(texture, "odd")->getText());
-			tmp.even = getColor(getChildElement(texture, "even")->getText());
-			tmp.scale = getFloat(getChildElement(texture, "scale")->getText());
+			tmp.odd = getColor(getChildElement(texture, sym::odd)->getTextValue());
+			tmp.even = getColor(getChildElement(texture, sym::even)->getTextValue());
+			tmp.scale = getFloat(getChildElement(texture, sym::scale)->getTextValue());
 			tex.data = std::move(tmp);
 		}
 	}
@@ -183,7 +176,7 @@ void SceneLoader::loadTextures()
 
 void SceneLoader::loadMaterials()
 {
-	auto it = getChildElement(ast_, "materials");
+	auto it = getChildElement(ast_, sym::materials);
 
 	if (it == ast_.getChildren().end())
 		return ;
@@ -193,121 +186,124 @@ void SceneLoader::loadMaterials()
 	for (const Node& material : materials.getChildren())
 	{
 		const auto& mat_attr = material.getAttributes();
-		const AttributeInfos& name = mat_attr.find("name")->second;
-		if (scene_.materials_.find(name.content) != scene_.materials_.end())
+		const AttributeInfos& nameAttr = mat_attr.find(sym::name)->second;
+		const std::string name(nameAttr.content);
+		if (scene_.materials_.find(name) != scene_.materials_.end())
 		{
-			errors_.report(TdrError(name.content_line, name.content_column, 2, "Duplicated material name, it will be ignored"));
+			auto pos = material.getPosition(nameAttr.content_offset);
+			errors_.report(TdrError(pos.first, pos.second, 2, "Duplicated material name, it will be ignored"));
 			continue;
 		}
 
-		Material& mat = scene_.materials_[name.content];
+		Material& mat = scene_.materials_[name];
 
-		mat.name = name.content;
+		mat.name = name;
 
-		auto label = mat_attr.find("label");
+		auto label = mat_attr.find(sym::label);
 		if (label != mat_attr.end()) mat.label = label->second.content;
 
 
 		for (const Node& prop : material.getChildren())
 		{
 			const auto& prop_attr = prop.getAttributes();
-			const auto& type_it = prop_attr.find("type");
+			const auto& type_it = prop_attr.find(sym::type);
 
 			if (type_it != prop_attr.end() && type_it->second.content == "texture")
 			{
-				if (scene_.textures_.find(prop.getText()) == scene_.textures_.end())
+				const std::string texture(prop.getText());
+				if (scene_.textures_.find(texture) == scene_.textures_.end())
 				{
 					const auto& pos = prop.getTextBeginPos();
-					errors_.report(TdrError(pos.first, pos.second, 2, "Unknown texture reference '"+ prop.getText() +"' in material '"+ mat.name +"' (property: "+ prop.getIdentifier() +")."));
+					errors_.report(TdrError(pos.first, pos.second, 2, "Unknown texture reference '"+ texture +"' in material '"+ mat.name +"' (property: "+ prop.getIdentifier() +")."));
 				}
 			}
 
-			if (prop.getIdentifier() == "albedo")
+			if (prop.getSymbol() == sym::albedo)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 				if (type == "texture")
-					mat.albedo = MaterialParam<cu::math::vec3>{ prop.getText() };
+					mat.albedo = MaterialParam<cu::math::vec3>{ std::string(prop.getText()) };
 				else
-					mat.albedo = MaterialParam<cu::math::vec3>{ getColor(prop.getText()) };
+					mat.albedo = MaterialParam<cu::math::vec3>{ getColor(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "metallic")
+			else if (prop.getSymbol() == sym::metallic)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.metallic = MaterialParam<float>{ prop.getText() };
+					mat.metallic = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.metallic = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.metallic = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "roughness")
+			else if (prop.getSymbol() == sym::roughness)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.roughness = MaterialParam<float>{ prop.getText() };
+					mat.roughness = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.roughness = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.roughness = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "transmission")
+			else if (prop.getSymbol() == sym::transmission)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.transmission = MaterialParam<float>{ prop.getText() };
+					mat.transmission = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.transmission = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.transmission = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "ambient_occlusion")
+			else if (prop.getSymbol() == sym::ambient_occlusion)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.ambient_occlusion = MaterialParam<float>{ prop.getText() };
+					mat.ambient_occlusion = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.ambient_occlusion = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.ambient_occlusion = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "roughness")
+			else if (prop.getSymbol() == sym::roughness)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.roughness = MaterialParam<float>{ prop.getText() };
+					mat.roughness = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.roughness = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.roughness = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "emission_strength")
+			else if (prop.getSymbol() == sym::emission_strength)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.emission_strength = MaterialParam<float>{ prop.getText() };
+					mat.emission_strength = MaterialParam<float>{ std::string(prop.getText()) };
 				else
-					mat.emission_strength = MaterialParam<float>{ getFloat(prop.getText()) };
+					mat.emission_strength = MaterialParam<float>{ getFloat(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "emission_color")
+			else if (prop.getSymbol() == sym::emission_color)
 			{
-				const std::string& type = type_it->second.content;
+				std::string_view type = type_it->second.content;
 
 				if (type == "texture")
-					mat.emission_color = MaterialParam<cu::math::vec3>{ prop.getText() };
+					mat.emission_color = MaterialParam<cu::math::vec3>{ std::string(prop.getText()) };
 				else
-					mat.emission_color = MaterialParam<cu::math::vec3>{ getColor(prop.getText()) };
+					mat.emission_color = MaterialParam<cu::math::vec3>{ getColor(prop.getTextValue()) };
 			}
-			else if (prop.getIdentifier() == "ior")
+			else if (prop.getSymbol() == sym::ior)
 			{
-				mat.ior = getFloat(prop.getText());
+				mat.ior = getFloat(prop.getTextValue());
 			}
-			else if (prop.getIdentifier() == "texture_scale")
+			else if (prop.getSymbol() == sym::texture_scale)
 			{
-				mat.texture_scale = getFloat(prop.getText());
+				mat.texture_scale = getFloat(prop.getTextValue());
 			}
-			else if (prop.getIdentifier() == "normal_map")
+			else if (prop.getSymbol() == sym::normal_map)
 			{
 				mat.normal_map = prop.getText();
 			}
-			else if (prop.getIdentifier() == "normal_intensity")
+			else if (prop.getSymbol() == sym::normal_intensity)
 			{
-				mat.normal_intensity = getFloat(prop.getText());
+				mat.normal_intensity = getFloat(prop.getTextValue());
 			}
 		}
 	}
@@ -316,7 +312,9 @@ void SceneLoader::loadMaterials()
 
 void SceneLoader::loadAssets()
 {
-	auto it = getChildElement(ast_, "assets");
+	assetStats_.clear();
+
+	auto it = getChildElement(ast_, sym::assets);
 
 	if (it == ast_.getChildren().end())
 		return ;
@@ -326,38 +324,52 @@ void SceneLoader::loadAssets()
 	for (const Node& asset_node : assets.getChildren())
 	{
 		const auto& asset_attr = asset_node.getAttributes();
-		const AttributeInfos& name = asset_attr.find("name")->second;
-		if (scene_.assets_.find(name.content) != scene_.assets_.end())
+		const AttributeInfos& nameAttr = asset_attr.find(sym::name)->second;
+		const std::string name(nameAttr.content);
+		if (scene_.assets_.find(name) != scene_.assets_.end())
 		{
-			errors_.report(TdrError(name.content_line, name.content_column, 2, "Duplicated asset name, the asset will be ignored"));
+			auto pos = asset_node.getPosition(nameAttr.content_offset);
+			errors_.report(TdrError(pos.first, pos.second, 2, "Duplicated asset name, the asset will be ignored"));
 			continue;
 		}
 
-		Asset& asset = scene_.assets_[name.content];
+		Asset& asset = scene_.assets_[name];
 
-		asset.name_ = name.content;
+		asset.name_ = name;
 
-		auto label = asset_attr.find("label");
+		auto label = asset_attr.find(sym::label);
 		if (label != asset_attr.end()) asset.label_ = label->second.content;
 
-		const std::string& type = asset_attr.find("type")->second.content;
+		std::string_view type = asset_attr.find(sym::type)->second.content;
 		if (type == "object")
 		{
-			const auto& obj = getChildElement(asset_node, "object");
-			const std::string& obj_type = obj->getAttributes().find("type")->second.content;
+			const auto& obj = getChildElement(asset_node, sym::object);
+			std::string_view obj_type = obj->getAttributes().find(sym::type)->second.content;
 			sceneIO::parser::ObjErrorCollector obj_errors;
+			sceneIO::parser::ObjParseOptions obj_options;
+
+			auto merge = obj->getAttributes().find(sym::merge_materials);
+			if (merge != obj->getAttributes().end())
+				obj_options.mergeMaterials = getBool(merge->second.value);
 
 			if (obj_type == "external")
 			{
-				const std::string& path = obj->getAttributes().find("path")->second.content;
-				sceneIO::parser::parseObj(asset, path, obj_errors);
+				const std::string path(obj->getAttributes().find(sym::path)->second.content);
+
+				std::string ext = std::filesystem::path(path).extension().string();
+				std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+
+				if (ext == ".glb")
+					sceneIO::parser::parseGlb(asset, path, obj_errors, &assetStats_[name]);
+				else
+					sceneIO::parser::parseObj(asset, path, obj_errors, &assetStats_[name], obj_options);
 			}
 			else
 			{
-				std::istringstream ss(obj->getText());
+				std::istringstream ss{ std::string(obj->getText()) };
 				const auto pos = obj->getTextBeginPos();
 
-				sceneIO::parser::parseObj(asset, ss, obj_errors, pos.first, pos.second);
+				sceneIO::parser::parseObj(asset, ss, obj_errors, pos.first, pos.second, &assetStats_[name], obj_options);
 				obj_errors.setFilePath(path_);
 			}
 
@@ -369,53 +381,72 @@ void SceneLoader::loadAssets()
 			}
 
 			if (obj_has_error) throw std::runtime_error("Cannot open the scene with an error present on the file.");
+
+			auto cleanup = obj->getAttributes().find(sym::cleanup);
+			if (cleanup != obj->getAttributes().end() && getBool(cleanup->second.value))
+			{
+				auto& object = std::get<Asset::ObjectData>(asset.content_);
+				sceneIO::parser::CleanupReport report = sceneIO::parser::cleanupAsset(object);
+
+				cu::logger::info("[Asset] " + name + " cleanup: "
+					+ std::to_string(report.weldedVertices) + " welded vertices, "
+					+ std::to_string(report.degenerateTriangles) + " degenerate triangles, "
+					+ std::to_string(report.duplicateTriangles) + " duplicated triangles, "
+					+ std::to_string(report.removedVertices) + " removed vertices");
+
+				assetStats_[name] = sceneIO::parser::computeAssetStats(object);
+			}
+
+			auto reorder = obj->getAttributes().find(sym::reorder);
+			if (reorder != obj->getAttributes().end() && reorder->second.content == "morton")
+				sceneIO::parser::reorderAsset(std::get<Asset::ObjectData>(asset.content_));
 		}
 		else if (type == "primitive")
 		{
 			Asset::PrimitiveData tmp = {};
 
-			const auto& prim = getChildElement(asset_node, "primitive");
-			const std::string& prim_type = prim->getAttributes().find("type")->second.content;
+			const auto& prim = getChildElement(asset_node, sym::primitive);
+			std::string_view prim_type = prim->getAttributes().find(sym::type)->second.content;
 
 			if (prim_type == "plane")
 			{
 				Asset::PrimitiveData::Plane tmp_prim = {};
 
-				tmp_prim.normal = getFloat(getChildElement(*prim, "normal")->getText());
+				tmp_prim.normal = getFloat(getChildElement(*prim, sym::normal)->getTextValue());
 				tmp.primitive = std::move(tmp_prim);
 			}
 			else if (prim_type == "sphere")
 			{
 				Asset::PrimitiveData::Sphere tmp_prim = {};
 
-				tmp_prim.radius = getFloat(getChildElement(*prim, "radius")->getText());
+				tmp_prim.radius = getFloat(getChildElement(*prim, sym::radius)->getTextValue());
 				tmp.primitive = std::move(tmp_prim);
 			}
 			else if (prim_type == "cylinder")
 			{
 				Asset::PrimitiveData::Cylinder tmp_prim = {};
 
-				tmp_prim.radius = getFloat(getChildElement(*prim, "radius")->getText());
-				tmp_prim.height = getFloat(getChildElement(*prim, "height")->getText());
+				tmp_prim.radius = getFloat(getChildElement(*prim, sym::radius)->getTextValue());
+				tmp_prim.height = getFloat(getChildElement(*prim, sym::height)->getTextValue());
 				tmp.primitive = std::move(tmp_prim);
 			}
 			else if (prim_type == "cone")
 			{
 				Asset::PrimitiveData::Cone tmp_prim = {};
 
-				tmp_prim.radius = getFloat(getChildElement(*prim, "radius")->getText());
-				tmp_prim.height = getFloat(getChildElement(*prim, "height")->getText());
+				tmp_prim.radius = getFloat(getChildElement(*prim, sym::radius)->getTextValue());
+				tmp_prim.height = getFloat(getChildElement(*prim, sym::height)->getTextValue());
 				tmp.primitive = std::move(tmp_prim);
 			}
 			else if (prim_type == "hyperboloid")
 			{
 				Asset::PrimitiveData::Hyperboloid tmp_prim = {};
 
-				tmp_prim.height = getFloat(getChildElement(*prim, "height")->getText());
-				tmp_prim.a = getFloat(getChildElement(*prim, "a")->getText());
-				tmp_prim.b = getFloat(getChildElement(*prim, "b")->getText());
-				tmp_prim.c = getFloat(getChildElement(*prim, "c")->getText());
-				tmp_prim.shape = getFloat(getChildElement(*prim, "shape")->getText());
+				tmp_prim.height = getFloat(getChildElement(*prim, sym::height)->getTextValue());
+				tmp_prim.a = getFloat(getChildElement(*prim, sym::a)->getTextValue());
+				tmp_prim.b = getFloat(getChildElement(*prim, sym::b)->getTextValue());
+				tmp_prim.c = getFloat(getChildElement(*prim, sym::c)->getTextValue());
+				tmp_prim.shape = getFloat(getChildElement(*prim, sym::shape)->getTextValue());
 				tmp.primitive = std::move(tmp_prim);
 			}
 
@@ -425,47 +456,46 @@ void SceneLoader::loadAssets()
 		{
 			Asset::InstanceData tmp = {};
 
-			tmp.parent_name = getChildElement(asset_node, "parent")->getAttributes().find("ref")->second.content;
+			tmp.parent_name = getChildElement(asset_node, sym::parent)->getAttributes().find(sym::ref)->second.content;
 
 			asset.content_ = std::move(tmp);
 		}
 
-		const auto& mat = getChildElement(asset_node, "material");
+		const auto& mat = getChildElement(asset_node, sym::material);
 		if (mat != asset_node.getChildren().end())
 		{
-			asset.material_ = mat->getAttributes().find("ref")->second.content;
+			asset.material_ = mat->getAttributes().find(sym::ref)->second.content;
 		}
 
-		const auto& transform = getChildElement(asset_node, "transform");
+		const auto& transform = getChildElement(asset_node, sym::transform);
 		if (transform != asset_node.getChildren().end())
 		{
-			const auto& transform_pos = getChildElement(*transform, "position");
+			const auto& transform_pos = getChildElement(*transform, sym::position);
 			if (transform_pos != transform->getChildren().end())
 			{
-				asset.transform_.setTranslation(getVec3(transform_pos->getText()));
+				asset.transform_.setTranslation(getVec3(transform_pos->getTextValue()));
 			}
 
-			const auto& transform_rotation = getChildElement(*transform, "rotation");
+			const auto& transform_rotation = getChildElement(*transform, sym::rotation);
 			if (transform_rotation != transform->getChildren().end())
 			{
-				std::string rot_type = transform_rotation->getAttributes().find("type")->second.content;
+				std::string_view rot_type = transform_rotation->getAttributes().find(sym::type)->second.content;
 
 				if (rot_type == "euler")
 				{
-					auto angles = getVec3(transform_rotation->getText());
+					auto angles = getVec3(transform_rotation->getTextValue());
 					asset.transform_.setEulerAngles(angles.x, angles.y, angles.z);
 				}
 				else
 				{
 					asset.transform_.setRotation(getQuat(transform_rotation->getText()));
-					throw std::runtime_error("J'ai eu la flemme d'implementer le parsing des quaternions donc je throw. A un moment je le gererai hein");
 				}
 			}
 
-			const auto& transform_scale = getChildElement(*transform, "scale");
+			const auto& transform_scale = getChildElement(*transform, sym::scale);
 			if (transform_scale != transform->getChildren().end())
 			{
-				asset.transform_.setScale(getVec3(transform_scale->getText()));
+				asset.transform_.setScale(getVec3(transform_scale->getTextValue()));
 			}
 		}
 	}
@@ -473,7 +503,7 @@ void SceneLoader::loadAssets()
 
 void SceneLoader::loadCameras()
 {
-	auto it = getChildElement(ast_, "cameras");
+	auto it = getChildElement(ast_, sym::cameras);
 
 	if (it == ast_.getChildren().end()) return;
 
@@ -482,62 +512,64 @@ void SceneLoader::loadCameras()
 	for (const Node& camera_node : cameras.getChildren())
 	{
 		const auto& cam_attr = camera_node.getAttributes();
-		const AttributeInfos& name = cam_attr.find("name")->second;
+		const AttributeInfos& nameAttr = cam_attr.find(sym::name)->second;
+		const std::string name(nameAttr.content);
 
-		if (scene_.cameras_.find(name.content) != scene_.cameras_.end())
+		if (scene_.cameras_.find(name) != scene_.cameras_.end())
 		{
-			errors_.report(TdrError(name.content_line, name.content_column, 2, "Duplicated camera name, it will be ignored"));
+			auto pos = camera_node.getPosition(nameAttr.content_offset);
+			errors_.report(TdrError(pos.first, pos.second, 2, "Duplicated camera name, it will be ignored"));
 			continue;
 		}
 
-		Camera& cam = scene_.cameras_[name.content];
-		cam.name = name.content;
+		Camera& cam = scene_.cameras_[name];
+		cam.name = name;
 
-		auto label = cam_attr.find("label");
+		auto label = cam_attr.find(sym::label);
 		if (label != cam_attr.end()) cam.label = label->second.content;
 
-		const std::string& projection = cam_attr.find("projection")->second.content;
+		std::string_view projection = cam_attr.find(sym::projection)->second.content;
 
 		if (projection == "perspective")
 		{
 			Camera::Perspective persp = {};
 
-			const Node& fov_node = *getChildElement(camera_node, "fov");
-			const std::string& fov_mode = fov_node.getAttributes().find("mode")->second.content;
+			const Node& fov_node = *getChildElement(camera_node, sym::fov);
+			std::string_view fov_mode = fov_node.getAttributes().find(sym::mode)->second.content;
 
 			if (fov_mode == "physical")
 			{
 				Camera::Perspective::PhysicalFOV phys = {};
 
-				const std::string& sensor_fit_str = fov_node.getAttributes().find("sensor_fit")->second.content;
+				std::string_view sensor_fit_str = fov_node.getAttributes().find(sym::sensor_fit)->second.content;
 				phys.sensor_fit = (sensor_fit_str == "vertical") ? Camera::Perspective::SensorFit::VERTICAL : Camera::Perspective::SensorFit::HORIZONTAL;
 
-				phys.focal_length = getFloat(getChildElement(fov_node, "focal_length")->getText());
-				phys.sensor_width  = getFloat(getChildElement(fov_node, "sensor_width")->getText());
-				phys.sensor_height = getFloat(getChildElement(fov_node, "sensor_height")->getText());
+				phys.focal_length = getFloat(getChildElement(fov_node, sym::focal_length)->getTextValue());
+				phys.sensor_width  = getFloat(getChildElement(fov_node, sym::sensor_width)->getTextValue());
+				phys.sensor_height = getFloat(getChildElement(fov_node, sym::sensor_height)->getTextValue());
 
 				persp.fov = phys;
 			}
 			else
 			{
-				persp.fov = getFloat(fov_node.getText());
+				persp.fov = getFloat(fov_node.getTextValue());
 			}
 
-			auto f_stop_it = getChildElement(camera_node, "f_stop");
+			auto f_stop_it = getChildElement(camera_node, sym::f_stop);
 			if (f_stop_it != camera_node.getChildren().end())
-				persp.f_stop = getFloat(f_stop_it->getText());
+				persp.f_stop = getFloat(f_stop_it->getTextValue());
 
-			auto ap_blades_it = getChildElement(camera_node, "aperture_blades");
+			auto ap_blades_it = getChildElement(camera_node, sym::aperture_blades);
 			if (ap_blades_it != camera_node.getChildren().end())
-				persp.aperture_blades = getInt(ap_blades_it->getText());
+				persp.aperture_blades = getInt(ap_blades_it->getTextValue());
 
-			auto ap_rot_it = getChildElement(camera_node, "aperture_rotation");
+			auto ap_rot_it = getChildElement(camera_node, sym::aperture_rotation);
 			if (ap_rot_it != camera_node.getChildren().end())
-				persp.aperture_rotation = getFloat(ap_rot_it->getText());
+				persp.aperture_rotation = getFloat(ap_rot_it->getTextValue());
 
-			auto shutter_it = getChildElement(camera_node, "shutter_speed");
+			auto shutter_it = getChildElement(camera_node, sym::shutter_speed);
 			if (shutter_it != camera_node.getChildren().end())
-				persp.shutter_speed = getFloat(shutter_it->getText());
+				persp.shutter_speed = getFloat(shutter_it->getTextValue());
 
 			cam.projection = persp;
 		}
@@ -545,7 +577,7 @@ void SceneLoader::loadCameras()
 		{
 			Camera::Orthographic ortho = {};
 
-			ortho.ortho_scale = getFloat(getChildElement(camera_node, "ortho_scale")->getText());
+			ortho.ortho_scale = getFloat(getChildElement(camera_node, sym::ortho_scale)->getTextValue());
 
 			cam.projection = ortho;
 		}
@@ -553,9 +585,9 @@ void SceneLoader::loadCameras()
 		{
 			Camera::Fisheye fisheye = {};
 
-			fisheye.fisheye_fov = getFloat(getChildElement(camera_node, "fisheye_fov")->getText());
+			fisheye.fisheye_fov = getFloat(getChildElement(camera_node, sym::fisheye_fov)->getTextValue());
 
-			const std::string& mapping_str = getChildElement(camera_node, "fisheye_mapping")->getText();
+			std::string_view mapping_str = getChildElement(camera_node, sym::fisheye_mapping)->getText();
 			if		(mapping_str == "equidistant")	fisheye.mapping = Camera::FisheyeMapping::EQUIDISTANT;
 			else if	(mapping_str == "equisolid")	fisheye.mapping = Camera::FisheyeMapping::EQUISOLID;
 			else if	(mapping_str == "orthographic")	fisheye.mapping = Camera::FisheyeMapping::ORTHOGRAPHIC;
@@ -567,28 +599,28 @@ void SceneLoader::loadCameras()
 		{
 			Camera::Panoramic panoramic = {};
 
-			const std::string& pan_type_str = getChildElement(camera_node, "panoramic_type")->getText();
+			std::string_view pan_type_str = getChildElement(camera_node, sym::panoramic_type)->getText();
 			if (pan_type_str == "mercator") panoramic.panoramic_type = Camera::PanoramicType::MERCATOR;
 			else panoramic.panoramic_type = Camera::PanoramicType::EQUIRECTANGULAR;
 
 			cam.projection = panoramic;
 		}
 
-		const Node& placement = *getChildElement(camera_node, "placement");
-		const std::string& placement_type = placement.getAttributes().find("type")->second.content;
+		const Node& placement = *getChildElement(camera_node, sym::placement);
+		std::string_view placement_type = placement.getAttributes().find(sym::type)->second.content;
 
-		cam.position = getVec3(getChildElement(placement, "position")->getText());
+		cam.position = getVec3(getChildElement(placement, sym::position)->getTextValue());
 
 		if (placement_type == "rotation")
 		{
-			const Node& rotation = *getChildElement(placement, "rotation");
-			const std::string& rot_type = rotation.getAttributes().find("type")->second.content;
+			const Node& rotation = *getChildElement(placement, sym::rotation);
+			std::string_view rot_type = rotation.getAttributes().find(sym::type)->second.content;
 
 			if (rot_type == "quaternion")
 				cam.rotation = getQuat(rotation.getText());
 			else
 			{
-				auto angles = getVec3(rotation.getText());
+				auto angles = getVec3(rotation.getTextValue());
 				cam.rotation = quat::fromEuler(angles.x, angles.y, angles.z);
 			}
 		}
@@ -596,11 +628,11 @@ void SceneLoader::loadCameras()
 		{
 			Camera::LookAt lookat = {};
 
-			lookat.lookat = getVec3(getChildElement(placement, "target")->getText());
+			lookat.lookat = getVec3(getChildElement(placement, sym::target)->getTextValue());
 
-			auto up_it = getChildElement(placement, "up");
+			auto up_it = getChildElement(placement, sym::up);
 			if (up_it != placement.getChildren().end())
-				lookat.up = getVec3(up_it->getText());
+				lookat.up = getVec3(up_it->getTextValue());
 			else
 				lookat.up = vec3(0.0f, 1.0f, 0.0f);
 
@@ -611,7 +643,7 @@ void SceneLoader::loadCameras()
 
 void SceneLoader::loadLights()
 {
-	auto it = getChildElement(ast_, "lights");
+	auto it = getChildElement(ast_, sym::lights);
 
 	if (it == ast_.getChildren().end()) return;
 
@@ -623,27 +655,27 @@ void SceneLoader::loadLights()
 
 		Light light = {};
 
-		auto label = light_attr.find("label");
+		auto label = light_attr.find(sym::label);
 		if (label != light_attr.end()) light.label = label->second.content;
 
-		light.color = getColor(getChildElement(light_node, "color")->getText());
+		light.color = getColor(getChildElement(light_node, sym::color)->getTextValue());
 
-		auto intensity_it = getChildElement(light_node, "intensity");
+		auto intensity_it = getChildElement(light_node, sym::intensity);
 		if (intensity_it != light_node.getChildren().end())
-			light.intensity = getFloat(intensity_it->getText());
+			light.intensity = getFloat(intensity_it->getTextValue());
 
-		const std::string& type = light_attr.find("type")->second.content;
+		std::string_view type = light_attr.find(sym::type)->second.content;
 
 		if (type == "point")
 		{
 			Light::Point point = {};
-			point.position = getVec3(getChildElement(light_node, "position")->getText());
+			point.position = getVec3(getChildElement(light_node, sym::position)->getTextValue());
 			light.projection = point;
 		}
 		else if (type == "directional")
 		{
 			Light::Directional directional = {};
-			directional.direction = getVec3(getChildElement(light_node, "direction")->getText());
+			directional.direction = getVec3(getChildElement(light_node, sym::direction)->getTextValue());
 			light.projection = directional;
 		}
 
@@ -653,7 +685,7 @@ void SceneLoader::loadLights()
 
 void SceneLoader::loadRender()
 {
-	auto it = getChildElement(ast_, "render");
+	auto it = getChildElement(ast_, sym::render);
 
 	if (it == ast_.getChildren().end()) return;
 
@@ -661,50 +693,52 @@ void SceneLoader::loadRender()
 
 	RenderSettings render_settings;
 
-	render_settings.width = getInt(getChildElement(render, "width")->getText());
-	render_settings.height = getInt(getChildElement(render, "height")->getText());
-	auto& cam = getChildElement(render, "camera")->getAttributes().find("ref")->second;
+	render_settings.width = getInt(getChildElement(render, sym::width)->getTextValue());
+	render_settings.height = getInt(getChildElement(render, sym::height)->getTextValue());
+	const auto& camera = getChildElement(render, sym::camera);
+	auto& cam = camera->getAttributes().find(sym::ref)->second;
 	render_settings.camera = cam.content;
 
-	if (scene_.cameras_.find(cam.content) == scene_.cameras_.end())
+	if (scene_.cameras_.find(render_settings.camera) == scene_.cameras_.end())
 	{
-		errors_.report(TdrError(cam.content_line, cam.content_column, 1, "Render camera ref does not exist"));
+		auto pos = camera->getPosition(cam.content_offset);
+		errors_.report(TdrError(pos.first, pos.second, 1, "Render camera ref does not exist"));
 		return ;
 	}
 
-	render_settings.max_bounces = getInt(getChildElement(render, "max_bounces")->getText());
+	render_settings.max_bounces = getInt(getChildElement(render, sym::max_bounces)->getTextValue());
 
-	auto samples_it = getChildElement(render, "samples");
+	auto samples_it = getChildElement(render, sym::samples);
 	if (samples_it != render.getChildren().end())
-		render_settings.samples = getInt(samples_it->getText());
+		render_settings.samples = getInt(samples_it->getTextValue());
 
-	auto output_it = getChildElement(render, "output");
+	auto output_it = getChildElement(render, sym::output);
 	if (output_it != render.getChildren().end())
 		render_settings.output_file = output_it->getText();
 }
 
 void SceneLoader::loadEnvironment()
 {
-	auto it = getChildElement(ast_, "environment");
+	auto it = getChildElement(ast_, sym::environment);
 
 	if (it == ast_.getChildren().end()) return;
 
 	const Node& env = *it;
 
-	const std::string& env_type = env.getAttributes().find("type")->second.content;
+	std::string_view env_type = env.getAttributes().find(sym::type)->second.content;
 
 	if (env_type == "skybox")
 	{
 		Environment::Skybox skybox;
 
-		skybox.path = getChildElement(env, "skybox")->getText();
-		skybox.rotation = getFloat(getChildElement(env, "rotation")->getText());
+		skybox.path = getChildElement(env, sym::skybox)->getText();
+		skybox.rotation = getFloat(getChildElement(env, sym::rotation)->getTextValue());
 
 		scene_.environment_.env = std::move(skybox);
 	}
 	else
 	{
-		scene_.environment_.env = getVec3(getChildElement(env, "color")->getText());
+		scene_.environment_.env = getVec3(getChildElement(env, sym::color)->getTextValue());
 	}
 }
 
@@ -717,9 +751,9 @@ Scene SceneLoader::load(const std::string& path)
 	std::function<void(const Node&)> loadLinksRecursive = [&](const Node& ast) {
 		for (const Node& link : ast.getChildren())
 		{
-			if (link.getIdentifier() == "link")
+			if (link.getSymbol() == sym::link)
 			{
-				std::string subpath = link.getAttributes().find("path")->second.content;
+				std::string subpath(link.getAttributes().find(sym::path)->second.content);
 				ParseResult subRes = SceneLanguageService::parse_file(subpath);
 				loadLinksRecursive(subRes.ast);
 				subfileRes.push_back(std::move(subRes));
@@ -730,50 +764,86 @@ Scene SceneLoader::load(const std::string& path)
 
 	std::cout << "Link number : " << subfileRes.size() << std::endl;
 
+	if (!res.ast.arena_)
+		res.ast.arena_ = std::make_shared<NodeArena>();
+
+	// Sections of the merged scene, and the items each one gains. Nodes are
+	// shallow copies: their children stay in the arena of their file.
+	std::vector<Node> sections(res.ast.getChildren().begin(), res.ast.getChildren().end());
+	std::vector<std::vector<Node>> addedItems(sections.size());
+
+	auto hasItemNamed = [](std::span<const Node> items, std::string_view name) {
+		for (const Node& item : items) {
+			auto nameIt = item.getAttributes().find(sym::name);
+			if (nameIt != item.getAttributes().end() && nameIt->second.content == name)
+				return true;
+		}
+		return false;
+	};
+
+	// ast_ outlives the results: the merged root keeps the arenas and
+	// sources of the grafted nodes, its own ones are held by res.ast
 	for (ParseResult& subRes : subfileRes) {
+		if (subRes.ast.arena_)
+			res.ast.arena_->keep(subRes.ast.arena_);
+		res.ast.arena_->keep(std::shared_ptr<const TokenSource>(subRes.source));
+
 		for (const Node& subChild : subRes.ast.getChildren()) {
-			if (subChild.getIdentifier() == "link")
+			if (subChild.getSymbol() == sym::link)
 				continue;
 			bool foundSection = false;
-			for (Node& mainChild : res.ast.children_) {
-				if (mainChild.getIdentifier() == subChild.getIdentifier()) {
+			for (size_t i = 0; i < sections.size(); i++) {
+				const Node& mainChild = sections[i];
+				// Unknown sections have symbols local to their own file
+				if (!subChild.getSymbol().local() && mainChild.getSymbol() == subChild.getSymbol()) {
 					foundSection = true;
 					for (const Node& subItem : subChild.getChildren()) {
 						bool isDuplicate = false;
-						auto subNameIt = subItem.getAttributes().find("name");
+						auto subNameIt = subItem.getAttributes().find(sym::name);
 						if (subNameIt != subItem.getAttributes().end()) {
-							std::string subItemName = subNameIt->second.content;
-
-							for (const Node& mainItem : mainChild.getChildren()) {
-								auto mainNameIt = mainItem.getAttributes().find("name");
-								if (mainNameIt != mainItem.getAttributes().end()) {
-									if (mainNameIt->second.content == subItemName) {
-										isDuplicate = true;
-										std::cout << "  Skipping duplicate '" << subItemName << "' in section '" << mainChild.getIdentifier() << "'\n";
-										break;
-									}
-								}
+							std::string_view subItemName = subNameIt->second.content;
+
+							if (hasItemNamed(mainChild.getChildren(), subItemName) || hasItemNamed(addedItems[i], subItemName)) {
+								isDuplicate = true;
+								std::cout << "  Skipping duplicate '" << subItemName << "' in section '" << mainChild.getIdentifier() << "'\n";
 							}
 						}
 						if (!isDuplicate) {
-							mainChild.children_.push_back(subItem);
+							addedItems[i].push_back(subItem);
 						}
 					}
 					break;
 				}
 			}
 			if (!foundSection) {
-				res.ast.children_.push_back(subChild);
+				sections.push_back(subChild);
+				addedItems.emplace_back();
 			}
 		}
 	}
 
-	res.ast.children_.erase(
-		std::remove_if(res.ast.children_.begin(), res.ast.children_.end(),
-			[](const Node& n) { return n.getIdentifier() == "link"; }),
-		res.ast.children_.end()
+	auto setChildren = [&](Node& node, std::vector<Node>& children) {
+		std::span<Node> run = res.ast.arena_->store(children);
+		node.children_ = run.data();
+		node.childCount_ = static_cast<uint32_t>(run.size());
+	};
+
+	for (size_t i = 0; i < sections.size(); i++) {
+		if (addedItems[i].empty())
+			continue;
+		std::vector<Node> items(sections[i].getChildren().begin(), sections[i].getChildren().end());
+		items.insert(items.end(), std::make_move_iterator(addedItems[i].begin()), std::make_move_iterator(addedItems[i].end()));
+		setChildren(sections[i], items);
+	}
+
+	sections.erase(
+		std::remove_if(sections.begin(), sections.end(),
+			[](const Node& n) { return n.getSymbol() == sym::link; }),
+		sections.end()
 	);
 
+	setChildren(res.ast, sections);
+
 	std::cout << "Merged scene created with all linked files\n";
 
 	bool	has_error = false;
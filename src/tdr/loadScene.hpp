@@ -2,6 +2,7 @@
 
 #include "tdr/parser.hpp"
 #include "scene-core.hpp"
+#include "meshStats.hpp"
 
 #include <exception>
 
@@ -13,11 +14,12 @@ class SceneLoader
 private:
 	std::string path_;
 	Scene scene_;
-	Node ast_;
+	Ast ast_;
 	ErrorCollector errors_;
+	std::map<std::string, parser::AssetStats> assetStats_;
 	
 
-	std::vector<sceneIO::tdr::Node>::const_iterator getChildElement(const Node& n, const std::string& name);
+	std::span<const sceneIO::tdr::Node>::iterator getChildElement(const Node& n, Symbol name);
 
 	void loadTextures();
 	void debugTextures() const;
@@ -31,6 +33,9 @@ private:
 public:
 	Scene load(const std::string& path);
 
+	// Bounds and geometry stats of every mesh asset of the last loaded scene, keyed by asset name
+	const std::map<std::string, parser::AssetStats>& getAssetStats() const { return assetStats_; }
+
 };
 
 }
\ No newline at end of file
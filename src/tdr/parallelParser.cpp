@@ -0,0 +1,311 @@
+#include "tdr/parser.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace sceneIO::tdr {
+
+namespace {
+
+// Below this size splitting the work costs more than it saves
+constexpr size_t minParallelSize = 1 << 20;
+constexpr size_t minChunkSize = 256 << 10;
+constexpr size_t minRunTokens = 1 << 12;
+
+/**
+ * Slice of the source lexed on its own thread, from a '<' starting a line
+ * to the start of the next slice.
+ */
+struct LexedChunk
+{
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	std::vector<Token> tokens;
+	std::vector<std::string> kept;	// rebuilt values, indexed by the tokens
+	bool clean = false;				// no diagnostic, and the next token starts the next slice
+};
+
+/**
+ * Top level element: its start tag, its end tag and the token ranges of its
+ * children, which are parsed apart from it.
+ */
+struct Section
+{
+	size_t begin = 0;
+	size_t startTagEnd = 0;
+	size_t endTagBegin = 0;
+	size_t end = 0;
+	std::vector<std::pair<size_t, size_t>> children;
+	std::vector<size_t> texts;
+};
+
+/**
+ * Tokens parsed by one worker: a section without its children, or a run of
+ * consecutive children of a section.
+ */
+struct ParseUnit
+{
+	size_t section = 0;
+	bool shell = false;
+	size_t begin = 0;
+	size_t end = 0;
+	Ast result;
+	bool clean = false;
+};
+
+/**
+ * Offset of the first '<' starting a line (after blanks) at or after
+ * @p from, the size of @p text if none.
+ */
+uint32_t nextSplit(std::string_view text, size_t from)
+{
+	size_t pos = from;
+
+	while ((pos = text.find('\n', pos)) != std::string_view::npos)
+	{
+		size_t first = text.find_first_not_of(" \t\r", pos + 1);
+		if (first == std::string_view::npos) break;
+		if (text[first] == '<') return static_cast<uint32_t>(first);
+		pos = first;
+	}
+	return static_cast<uint32_t>(text.size());
+}
+
+/**
+ * Lexes @p chunk from its begin as if the whole source had been lexed up to
+ * there. That holds when the stream reaches the '<' of the next slice as a
+ * tag token: a lexer always starts a token at such a '<', in the same state.
+ */
+void lexChunk(TokenSource& source, LexedChunk& chunk, bool last)
+{
+	ErrorCollector errors;
+	TokenStream stream(source, errors, chunk.begin, &chunk.kept);
+
+	while (stream.peek().type != TokenType::END_OF_FILE && stream.peek().offset < chunk.end)
+		chunk.tokens.push_back(stream.advance());
+
+	const Token& next = stream.peek();
+	bool reachedEnd = last
+		? next.type == TokenType::END_OF_FILE
+		: (next.type == TokenType::TAG_OPEN || next.type == TokenType::TAG_END_OPEN) && next.offset == chunk.end;
+
+	if (last && reachedEnd) chunk.tokens.push_back(next);
+	chunk.clean = reachedEnd && !errors.has_errors();
+}
+
+/**
+ * Finds the sections of a well formed token list. False on anything the
+ * parser would report, which is left to it.
+ */
+bool findSections(const TokenSource& source, const std::vector<Token>& tokens, std::vector<Section>& sections)
+{
+	std::vector<std::string_view> open;
+	size_t i = 0;
+
+	while (tokens[i].type != TokenType::END_OF_FILE)
+	{
+		const size_t start = i;
+
+		if (tokens[i].type == TokenType::TAG_OPEN)
+		{
+			if (tokens[++i].type != TokenType::IDENTIFIER) return false;
+			std::string_view name = source.value(tokens[i++]);
+
+			while (tokens[i].type == TokenType::IDENTIFIER)
+			{
+				i++;
+				if (tokens[i].type != TokenType::EQUALS) continue;
+				if (tokens[++i].type != TokenType::STRING) return false;
+				i++;
+			}
+
+			const bool selfClosed = tokens[i].type == TokenType::TAG_SELF_CLOSE;
+			if (!selfClosed && tokens[i].type != TokenType::TAG_CLOSE) return false;
+			i++;
+
+			if (open.empty())
+			{
+				Section& section = sections.emplace_back();
+				section.begin = start;
+				section.startTagEnd = i;
+				if (selfClosed) section.endTagBegin = section.end = i;
+			}
+			else if (open.size() == 1)
+				sections.back().children.emplace_back(start, i);
+
+			if (!selfClosed) open.push_back(name);
+		}
+		else if (tokens[i].type == TokenType::TAG_END_OPEN)
+		{
+			if (open.empty() || tokens[++i].type != TokenType::IDENTIFIER) return false;
+			if (source.value(tokens[i++]) != open.back()) return false;
+			if (tokens[i++].type != TokenType::TAG_CLOSE) return false;
+
+			open.pop_back();
+
+			if (open.empty())
+			{
+				sections.back().endTagBegin = start;
+				sections.back().end = i;
+			}
+			else if (open.size() == 1)
+				sections.back().children.back().second = i;
+		}
+		else if (tokens[i].type == TokenType::TEXT && !open.empty())
+		{
+			if (open.size() == 1) sections.back().texts.push_back(i);
+			i++;
+		}
+		else return false;
+	}
+
+	return open.empty();
+}
+
+}
+
+Ast parseParallel(TokenSource& source, ErrorCollector& errors)
+{
+	ParseContext context;
+	return parseParallel(source, errors, context);
+}
+
+Ast parseParallel(TokenSource& source, ErrorCollector& errors, ParseContext& context)
+{
+	const std::string_view text = source.text();
+	const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+	auto serial = [&]()
+	{
+		TokenStream tokens(source, errors);
+		return parser(tokens, errors, context);
+	};
+
+	if (threads <= 1 || text.size() < minParallelSize || text.size() >= UINT32_MAX)
+		return serial();
+
+	// Lexing: the source is split at lines starting with '<'
+	std::vector<LexedChunk> chunks;
+	const size_t chunkSize = std::max(minChunkSize, text.size() / (4 * threads));
+
+	for (uint32_t begin = 0; begin < text.size(); )
+	{
+		uint32_t end = begin + chunkSize < text.size() ? nextSplit(text, begin + chunkSize) : static_cast<uint32_t>(text.size());
+		chunks.push_back({ begin, end });
+		begin = end;
+	}
+
+	sceneIO::parallelFor(chunks.size(), [&](size_t c)
+	{
+		lexChunk(source, chunks[c], c + 1 == chunks.size());
+	});
+
+	for (const LexedChunk& chunk : chunks)
+		if (!chunk.clean) return serial();
+
+	std::vector<Token> tokens;
+	size_t tokenCount = 0;
+	for (const LexedChunk& chunk : chunks)
+		tokenCount += chunk.tokens.size();
+	tokens.reserve(tokenCount);
+
+	for (LexedChunk& chunk : chunks)
+	{
+		const uint32_t base = static_cast<uint32_t>(source.keptCount());
+		for (std::string& value : chunk.kept)
+			source.keep(std::move(value));
+
+		for (Token tok : chunk.tokens)
+		{
+			if (tok.rebuilt) tok.length += base;
+			tokens.push_back(tok);
+		}
+	}
+
+	// Parsing: each section without its children, and runs of children
+	std::vector<Section> sections;
+	if (!findSections(source, tokens, sections)) return serial();
+
+	const size_t runTokens = std::max(minRunTokens, tokens.size() / (8 * threads));
+	std::vector<ParseUnit> units;
+
+	for (size_t s = 0; s < sections.size(); s++)
+	{
+		const Section& section = sections[s];
+		units.push_back({ .section = s, .shell = true, .begin = section.begin, .end = section.end });
+
+		for (size_t c = 0; c < section.children.size(); )
+		{
+			size_t first = c;
+			while (c < section.children.size() && section.children[c].second - section.children[first].first < runTokens)
+				c++;
+			if (c == first) c++;
+
+			units.push_back({ .section = s, .begin = section.children[first].first, .end = section.children[c - 1].second });
+		}
+	}
+
+	sceneIO::parallelFor(units.size(), [&](size_t u)
+	{
+		ParseUnit& unit = units[u];
+		std::vector<Token> unitTokens;
+
+		if (unit.shell)
+		{
+			const Section& section = sections[unit.section];
+			unitTokens.assign(tokens.begin() + section.begin, tokens.begin() + section.startTagEnd);
+			for (size_t t : section.texts)
+				unitTokens.push_back(tokens[t]);
+			unitTokens.insert(unitTokens.end(), tokens.begin() + section.endTagBegin, tokens.begin() + section.end);
+		}
+		else unitTokens.assign(tokens.begin() + unit.begin, tokens.begin() + unit.end);
+
+		unitTokens.push_back({ TokenType::END_OF_FILE, false, tokens[unit.end].offset, 0 });
+
+		ErrorCollector unitErrors;
+		TokenStream stream(source, unitTokens, unitErrors);
+		unit.result = parser(stream, unitErrors);
+		unit.clean = !unitErrors.has_errors();
+	});
+
+	for (const ParseUnit& unit : units)
+		if (!unit.clean) return serial();
+
+	// Stitching: children runs are kept in their own arenas, like the
+	// symbol scopes of every unit
+	Ast root;
+	root.source_ = &source;
+	root.sourceOwner_ = source.weak_from_this().lock();
+	root.arena_ = context.acquireArena();
+
+	std::vector<Node> sectionNodes;
+	std::vector<Node> children;
+
+	for (size_t u = 0; u < units.size(); )
+	{
+		root.arena_->keep(units[u].result.arena_);
+		Node section = std::move(units[u].result.children().front());
+		children.clear();
+
+		for (u++; u < units.size() && !units[u].shell; u++)
+		{
+			root.arena_->keep(units[u].result.arena_);
+			for (Node& child : units[u].result.children())
+				children.push_back(std::move(child));
+		}
+
+		std::span<Node> run = root.arena_->store(children);
+		section.children_ = run.data();
+		section.childCount_ = static_cast<uint32_t>(run.size());
+		sectionNodes.push_back(std::move(section));
+	}
+
+	std::span<Node> run = root.arena_->store(sectionNodes);
+	root.children_ = run.data();
+	root.childCount_ = static_cast<uint32_t>(run.size());
+
+	return root;
+}
+
+}
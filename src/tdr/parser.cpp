@@ -1,40 +1,58 @@
 #include "tdr/parser.hpp"
 #include <iostream>
 #include "colors.hpp"
-#include <memory>
-#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 namespace sceneIO::tdr {
 
-Node parser(std::vector<Token>& list, ErrorCollector& errors)
+namespace {
+
+enum class TagState { Open, Closed, Failed };
+
+}
+
+Ast parser(TokenStream& tokens, ErrorCollector& errors)
 {
-	Node root;
+	ParseContext context;
+	return parser(tokens, errors, context);
+}
+
+Ast parser(TokenStream& tokens, ErrorCollector& errors, ParseContext& context)
+{
+	const TokenSource& source = tokens.source();
 
-	size_t cursor = 0;
+	Ast root;
+	root.source_ = &source;
+	root.sourceOwner_ = source.weak_from_this().lock();
 
-	auto peek = [&]() -> Token&
+	auto peek = [&]() -> const Token&
 	{
-		return list[cursor];
+		return tokens.peek();
 	};
 
-	auto last = [&]() -> Token&
+	auto last = [&]() -> const Token&
 	{
-		if (cursor > 0) return list[cursor - 1];
-		return list[cursor];
+		return tokens.last();
 	};
 
-	auto advance = [&](const std::unique_ptr<Node>& node) -> Token&
+	auto advance = [&](Node *node) -> Token
 	{
-		if (cursor >= list.size()) throw TdrError("Internal TDR parser error: cursor overflow");
-		
-		Token& current = list[cursor];
+		Token current = tokens.advance();
 		
-		if (node) node->tokens_.push_back(current);
+		if (node && current.type == TokenType::IDENTIFIER && node->beginOffset_ == UINT32_MAX)
+			node->beginOffset_ = current.offset;
 		
-		cursor++;
 		return current;
 	};
 
+	auto error_at = [&](const Token& tok, const std::string& msg)
+	{
+		auto [line, column] = source.position(tok.offset);
+		errors.report(TdrError(line, column, msg));
+	};
+
 	auto skip_close_tag_unwanted_token = [&]()
 	{
 		while (peek().type != TokenType::IDENTIFIER
@@ -46,168 +64,234 @@ Node parser(std::vector<Token>& list, ErrorCollector& errors)
 		}
 	};
 
-	std::function<std::unique_ptr<Node>()> parseNode = [&]() -> std::unique_ptr<Node>
+	std::vector<AttributeMap::value_type>& attributes = context.attributes_;	// of the start tag being read
+
+	/**
+	 * Parses a start tag into @p node. Open: its content follows, Closed:
+	 * it was self closed, Failed: the file ended in the middle of it.
+	 */
+	auto parseStartTag = [&](Node& node) -> TagState
 	{
-		auto eofError = [&]() -> std::unique_ptr<Node>
+		auto eofError = [&]() -> TagState
 		{
-			errors.report(TdrError(peek().line, peek().column, "Unexpected end of file"));
-			return nullptr;
+			error_at(peek(), "Unexpected end of file");
+			return TagState::Failed;
 		};
 
-		auto res = std::make_unique<Node>();
+		node.source_ = &source;
 
-		advance(res);
+		advance(&node);
 
 		if (peek().type == TokenType::END_OF_FILE) return eofError();
-		else if (peek().type != TokenType::IDENTIFIER) errors.report(TdrError(peek().line, peek().column, "Tag identifier expected"));
-		else res->identifier_ = peek().value;
+		else if (peek().type != TokenType::IDENTIFIER) error_at(peek(), "Tag identifier expected");
+		else node.identifier_ = source.symbols().get(source.value(peek()));
 
-		advance(res);
+		advance(&node);
+
+		// Sorted by name as they are read, a duplicate replaces the first one
+		attributes.clear();
 
 		while (peek().type == TokenType::IDENTIFIER)
 		{
-			std::string& propertyName = peek().value;
-			AttributeInfos attr;
-			attr.attr_line = peek().line;
-			attr.attr_column = peek().column;
-			
-			if (res->attributes_.find(propertyName) != res->attributes_.end())
-				errors.report(TdrError(peek().line, peek().column, "Duplicated attribute '" + propertyName + "'"));
-			
-			res->attributes_[propertyName] = attr;
+			const Symbol propertyName = source.symbols().get(source.value(peek()));
+			auto attr = std::lower_bound(attributes.begin(), attributes.end(), propertyName,
+				[](const AttributeMap::value_type& entry, Symbol key) { return entry.first < key; });
 
-			advance(res);
+			if (attr != attributes.end() && attr->first == propertyName)
+			{
+				error_at(peek(), "Duplicated attribute '" + node.nameOf(propertyName) + "'");
+				attr->second = AttributeInfos();
+			}
+			else attr = attributes.emplace(attr, propertyName, AttributeInfos());
+
+			attr->second.attr_offset = peek().offset;
+
+			advance(&node);
 
 			if (peek().type == TokenType::END_OF_FILE) return eofError();
 			else if (peek().type == TokenType::EQUALS)
 			{
-				advance(res);
+				advance(&node);
 
 				if (peek().type == TokenType::END_OF_FILE) return eofError();
 				else if (peek().type == TokenType::STRING)
 				{
-					attr.content_line = peek().line;
-					attr.content_column = peek().column + 1;
-					attr.content = peek().value;
-					res->attributes_[propertyName] = attr;
-					advance(res);
+					// Rebuilt values are kept by the source as well
+					attr->second.content_offset = peek().offset + 1;
+					attr->second.content = source.value(peek());
+					advance(&node);
 				}
-				else errors.report(TdrError(peek().line, peek().column, "Expected string value after '=' (did you forget quotes?)"));
+				else error_at(peek(), "Expected string value after '=' (did you forget quotes?)");
 			}
 		}
 
+		node.setAttributes(root.arena_->store(attributes));
+
 		if (peek().type == TokenType::END_OF_FILE) return eofError();
 		else if (peek().type == TokenType::TAG_SELF_CLOSE)
 		{
-			advance(res);
-			return res;
+			advance(&node);
+			return TagState::Closed;
 		}
+
+		if (peek().type == TokenType::TAG_CLOSE)
+			advance(&node);
 		else
+			error_at(last(), "Unclosed tag '" + node.getIdentifier() + "' inside a tag. Close it with '>' or '/>'");
+
+		return TagState::Open;
+	};
+
+	/**
+	 * Parses the end tag starting at the current '</' token. Closed: @p node
+	 * is done, whether the tag matched or not (a tag of a parent is left to
+	 * it), Failed: the file ended in the middle of it.
+	 */
+	auto parseEndTag = [&](Node& node) -> TagState
+	{
+		auto eofError = [&]() -> TagState
 		{
-			if (peek().type == TokenType::TAG_CLOSE)
-				advance(res);
-			else
-				errors.report(TdrError(last().line, last().column, "Unclosed tag '" + res->identifier_ + "' inside a tag. Close it with '>' or '/>'"));;
+			error_at(peek(), "Unexpected end of file");
+			return TagState::Failed;
+		};
 
-			while (peek().type != TokenType::END_OF_FILE)
-			{
-				if (peek().type == TokenType::TEXT)
-				{
-					if (res->text_.empty()) res->text_ = peek().value;
-					else errors.report(TdrError(peek().line, peek().column, "Multiple text blocks not allowed (text content must be in a single block)"));
-					advance(res);
-				}
-				else if (peek().type == TokenType::TAG_END_OPEN)
-				{
-					advance(res);
-
-					if (peek().type != TokenType::IDENTIFIER) errors.report(TdrError(peek().line, peek().column, "Invalid end of tag. Expected '</" + res->identifier_ + ">'"));
-					skip_close_tag_unwanted_token();
-
-					if (peek().type == TokenType::END_OF_FILE) return eofError();
-					else if (peek().type == TokenType::TAG_CLOSE || peek().type == TokenType::TAG_SELF_CLOSE)
-					{
-						errors.report(TdrError(peek().line, peek().column, "Invalid close tag. Expected '</" + res->identifier_ + ">'"));
-						advance(res);
-						return res;
-					}
-
-					if (peek().value == res->identifier_)
-					{
-						advance(res);
-						if (peek().type == TokenType::TAG_CLOSE)
-						{
-							advance(res);
-							return res;
-						}
-						errors.report(TdrError(peek().line, peek().column, "Invalid end of tag. Expected '</" + res->identifier_ + ">'"));
-						
-						while (peek().type != TokenType::TAG_CLOSE && peek().type != TokenType::END_OF_FILE)
-						{
-							if (peek().type == TokenType::TAG_SELF_CLOSE)
-							{
-								errors.report(TdrError(peek().line, peek().column, "Found '/>' instead of '>'"));
-								advance(res);
-								return res;
-							}
-							else if (peek().type == TokenType::TAG_OPEN || peek().type == TokenType::TAG_END_OPEN)
-							{
-								errors.report(TdrError(peek().line, peek().column, "Unclosed tag '</" + res->identifier_ + "'"));
-								return res;
-							}
-							else
-								advance(nullptr);
-						}
-						
-						if (peek().type == TokenType::TAG_CLOSE)
-						{
-							advance(res);
-							return res;
-						}
-						else return eofError();
-					}
-					else
-					{
-						if (cursor < 2) throw TdrError("Internal TDR parser error: cursor underflow protection");
-						cursor--;
-						errors.report(TdrError(peek().line, peek().column, "Unclosed tag '<" + res->identifier_ + ">'"));
-						return res;
-					}
-				}
-				else if (peek().type == TokenType::TAG_OPEN)
-				{
-					std::unique_ptr<Node> child = parseNode();
+		advance(&node);
 
-					if (child == nullptr) return nullptr;
+		if (peek().type != TokenType::IDENTIFIER) error_at(peek(), "Invalid end of tag. Expected '</" + node.getIdentifier() + ">'");
+		skip_close_tag_unwanted_token();
 
-					res->children_.push_back(std::move(*child));
-				}
-				else
-				{
-					errors.report(TdrError(peek().line, peek().column, "Unexpected token '" + getTokenContent(peek()) + "'."));
-					advance(nullptr);
-				}
+		if (peek().type == TokenType::END_OF_FILE) return eofError();
+		else if (peek().type == TokenType::TAG_CLOSE || peek().type == TokenType::TAG_SELF_CLOSE)
+		{
+			error_at(peek(), "Invalid close tag. Expected '</" + node.getIdentifier() + ">'");
+			advance(&node);
+			return TagState::Closed;
+		}
+
+		if (source.value(peek()) != node.getIdentifier())
+		{
+			tokens.back();
+			error_at(peek(), "Unclosed tag '<" + node.getIdentifier() + ">'");
+			return TagState::Closed;
+		}
+
+		node.endNameOffset_ = advance(&node).offset;
+		if (peek().type == TokenType::TAG_CLOSE)
+		{
+			advance(&node);
+			return TagState::Closed;
+		}
+		error_at(peek(), "Invalid end of tag. Expected '</" + node.getIdentifier() + ">'");
+		
+		while (peek().type != TokenType::TAG_CLOSE && peek().type != TokenType::END_OF_FILE)
+		{
+			if (peek().type == TokenType::TAG_SELF_CLOSE)
+			{
+				error_at(peek(), "Found '/>' instead of '>'");
+				advance(&node);
+				return TagState::Closed;
+			}
+			else if (peek().type == TokenType::TAG_OPEN || peek().type == TokenType::TAG_END_OPEN)
+			{
+				error_at(peek(), "Unclosed tag '</" + node.getIdentifier() + "'");
+				return TagState::Closed;
 			}
+			else
+				advance(nullptr);
 		}
 		
-		return res;
+		if (peek().type == TokenType::TAG_CLOSE)
+		{
+			advance(&node);
+			return TagState::Closed;
+		}
+		return eofError();
+	};
+
+	// Nodes being built: each open tag followed by the children it has so
+	// far. When a tag closes, its children move to the arena as one run.
+	std::vector<Node>& pending = context.pending_;
+	std::vector<size_t>& open = context.open_;		// index in pending of the open tags, innermost last
+
+	pending.clear();
+	open.clear();
+
+	auto storeChildren = [&](Node& node, size_t first)
+	{
+		std::span<Node> run = root.arena_->store(std::span<Node>(pending).subspan(first));
+		node.children_ = run.data();
+		node.childCount_ = static_cast<uint32_t>(run.size());
+		pending.resize(first);
+	};
+
+	auto closeTag = [&]()
+	{
+		size_t index = open.back();
+		open.pop_back();
+		storeChildren(pending[index], index + 1);
 	};
 
-	while (peek().type != TokenType::END_OF_FILE)
+	// The file ended inside a tag: the whole top level element is dropped
+	auto dropTopLevel = [&]()
+	{
+		pending.resize(open.empty() ? pending.size() - 1 : open.front());
+		open.clear();
+	};
+
+	root.arena_ = context.acquireArena();
+
+	while (true)
 	{
-		if (peek().type == TokenType::TAG_OPEN)
+		const bool isRoot = open.empty();
+
+		if (peek().type == TokenType::END_OF_FILE)
+		{
+			// Tags still open at the end of the file are kept as they are
+			if (isRoot) break;
+			closeTag();
+		}
+		else if (peek().type == TokenType::TAG_OPEN)
 		{
-			std::unique_ptr<Node> child = parseNode();
+			TagState state = parseStartTag(pending.emplace_back());
 
-			if (child) root.children_.push_back(std::move(*child));
+			if (state == TagState::Open) open.push_back(pending.size() - 1);
+			else if (state == TagState::Failed) dropTopLevel();
+		}
+		else if (isRoot)
+		{
+			error_at(peek(), "Unexpected token '" + getTokenContent(peek(), source) + "'.");
+			advance(nullptr);
+		}
+		else if (peek().type == TokenType::TEXT)
+		{
+			Node& parent = pending[open.back()];
+
+			// A block left empty by comments does not count
+			if (parent.getText().empty())
+			{
+				parent.textOffset_ = peek().offset;
+				parent.textLength_ = peek().length;
+				parent.textRebuilt_ = peek().rebuilt;
+			}
+			else error_at(peek(), "Multiple text blocks not allowed (text content must be in a single block)");
+			advance(&parent);
+		}
+		else if (peek().type == TokenType::TAG_END_OPEN)
+		{
+			TagState state = parseEndTag(pending[open.back()]);
+
+			if (state == TagState::Closed) closeTag();
+			else dropTopLevel();
 		}
 		else
 		{
-			errors.report(TdrError(peek().line, peek().column, "Unexpected token '" + getTokenContent(peek()) + "'."));
+			error_at(peek(), "Unexpected token '" + getTokenContent(peek(), source) + "'.");
 			advance(nullptr);
 		}
 	}
 
+	storeChildren(root, 0);
+
 	return root;
 
 }
@@ -217,14 +301,14 @@ void Node::print(int nest) const
 	COLORS_INIT();
 	std::string indent(nest * 2, ' ');
 	
-	std::cout << indent << COLOR_CYAN << "<" << identifier_ << COLOR_RESET;
+	std::cout << indent << COLOR_CYAN << "<" << getIdentifier() << COLOR_RESET;
 	
-	for (const auto& [key, value] : attributes_)
+	for (const auto& [key, value] : getAttributes())
 	{
-		std::cout << " " << COLOR_YELLOW << key << COLOR_RESET << "=" << COLOR_GREEN << "\"" << value.content << "\"" << COLOR_RESET;
+		std::cout << " " << COLOR_YELLOW << nameOf(key) << COLOR_RESET << "=" << COLOR_GREEN << "\"" << value.content << "\"" << COLOR_RESET;
 	}
 
-	if (children_.empty() && text_.empty())
+	if (childCount_ == 0 && getText().empty())
 	{
 		std::cout << COLOR_CYAN << " />" << COLOR_RESET << std::endl;
 	}
@@ -232,58 +316,138 @@ void Node::print(int nest) const
 	{
 		std::cout << COLOR_CYAN << ">" << COLOR_RESET;
 
-		bool hasContent = !text_.empty();
+		bool hasContent = !getText().empty();
 		if (hasContent)
 		{
-			std::cout << COLOR_WHITE << text_ << COLOR_RESET;
+			std::cout << COLOR_WHITE << getText() << COLOR_RESET;
 		}
 		
-		if (!children_.empty())
+		if (childCount_ != 0)
 		{
 			if (hasContent) std::cout << std::endl;
 			else std::cout << std::endl;
 			
-			for (const Node& child : children_)
+			for (const Node& child : getChildren())
 			{
 				child.print(nest + 1);
 			}
 			std::cout << indent;
 		}
 		
-		if (!children_.empty())
-			std::cout << COLOR_CYAN << "</" << identifier_ << ">" << COLOR_RESET << std::endl;
+		if (childCount_ != 0)
+			std::cout << COLOR_CYAN << "</" << getIdentifier() << ">" << COLOR_RESET << std::endl;
 		else
-			std::cout << COLOR_CYAN << "</" << identifier_ << ">" << COLOR_RESET << std::endl;
+			std::cout << COLOR_CYAN << "</" << getIdentifier() << ">" << COLOR_RESET << std::endl;
 	}
 }
 
 
 const std::pair<uint64_t, uint64_t> Node::getTextBeginPos() const
 {
-	auto pos = getNodeBeginPos();
-	for (const auto& token : tokens_)
+	if (source_ && textOffset_ != UINT32_MAX) return source_->position(textOffset_);
+	return getNodeBeginPos();
+}
+
+const std::pair<uint64_t, uint64_t> Node::getNodeBeginPos() const
+{
+	return getPosition(getNodeBeginOffset());
+}
+
+std::pair<uint64_t, uint64_t> Node::getPosition(uint32_t offset) const
+{
+	if (!source_ || offset == UINT32_MAX) return { UINT64_MAX, UINT64_MAX };
+	return source_->position(offset);
+}
+
+template <typename T>
+std::span<T> NodeArena::Runs<T>::store(std::span<T> items)
+{
+	if (items.empty()) return {};
+
+	std::vector<T>& block = blockFor(items.size());
+
+	// Within the reserved capacity: items already stored never move
+	size_t first = block.size();
+	std::move(items.begin(), items.end(), std::back_inserter(block));
+	return { block.data() + first, items.size() };
+}
+
+template <typename T>
+std::vector<T>& NodeArena::Runs<T>::blockFor(size_t count)
+{
+	// Long runs get a block of their own, the current one keeps filling up
+	if (count >= blockSize / 4)
 	{
-		if (token.type == TokenType::TEXT)
+		auto spare = std::find_if(longRuns_.begin() + longRunsUsed_, longRuns_.end(),
+			[count](const std::vector<T>& block) { return block.capacity() >= count; });
+
+		if (spare == longRuns_.end())
 		{
-			pos.first = token.line;
-			pos.second = token.column;
-			break;
+			longRuns_.emplace_back().reserve(count);
+			spare = longRuns_.end() - 1;
 		}
+		std::swap(*spare, longRuns_[longRunsUsed_]);
+		return longRuns_[longRunsUsed_++];
 	}
-	return pos;
+
+	while (current_ < blocks_.size() && blocks_[current_].capacity() - blocks_[current_].size() < count)
+		current_++;
+
+	if (current_ == blocks_.size())
+		blocks_.emplace_back().reserve(blockSize);
+	return blocks_[current_];
 }
 
-const std::pair<uint64_t, uint64_t> Node::getNodeBeginPos() const
+template <typename T>
+void NodeArena::Runs<T>::clear()
+{
+	for (std::vector<T>& block : blocks_)
+		block.clear();
+	for (std::vector<T>& block : longRuns_)
+		block.clear();
+
+	current_ = 0;
+	longRunsUsed_ = 0;
+}
+
+void NodeArena::clear()
 {
-	size_t i = 0;
+	nodes_.clear();
+	attributes_.clear();
+	strings_.clear();
+	kept_.clear();
+	keptSources_.clear();
+}
+
+std::shared_ptr<TokenSource> ParseContext::acquireSource(std::string_view content)
+{
+	for (std::shared_ptr<TokenSource>& source : sources_)
+	{
+		if (source.use_count() != 1) continue;
+		source->reset(content);
+		return source;
+	}
+
+	std::shared_ptr<TokenSource> source = TokenSource::fromString(std::string(content));
+	if (sources_.size() < poolSize) sources_.push_back(source);
+	return source;
+}
 
-	while (i < tokens_.size())
+std::shared_ptr<NodeArena> ParseContext::acquireArena()
+{
+	for (std::shared_ptr<NodeArena>& arena : arenas_)
 	{
-		if (tokens_[i].type == TokenType::IDENTIFIER)
-			return { tokens_[i].line, tokens_[i].column };
-		i++;
+		if (arena.use_count() != 1) continue;
+		arena->clear();
+		return arena;
 	}
-	return { UINT64_MAX, UINT64_MAX };
+
+	std::shared_ptr<NodeArena> arena = std::make_shared<NodeArena>();
+	if (arenas_.size() < poolSize) arenas_.push_back(arena);
+	return arena;
 }
 
-}
\ No newline at end of file
+template class NodeArena::Runs<Node>;
+template class NodeArena::Runs<AttributeMap::value_type>;
+
+}
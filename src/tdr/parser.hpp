@@ -2,58 +2,284 @@
 
 #include "tdr/lexer.hpp"
 #include "tdr/error.hpp"
+#include "tdr/symbols.hpp"
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
 
 namespace sceneIO::tdr {
 
 class SceneSchema;
 struct TagSchema;
+class NodeArena;
+class ParseContext;
+class Ast;
+
+struct EnumIndex
+{
+	uint32_t index;		// in the enum values of the schema
+};
+
+/**
+ * Value of an attribute or a text, decoded by the semantic analyzer while
+ * validating it so that the loader does not parse it again. Vec3 and colors
+ * hold three floats, colors normalized to [0, 1]. Empty for strings, file
+ * paths, and values that are invalid or have no type in the schema.
+ */
+using TypedValue = std::variant<std::monostate, float, int, bool, std::array<float, 3>, EnumIndex>;
 
 struct AttributeInfos
 {
-	std::string content;
-	uint64_t attr_line = UINT64_MAX;
-	uint64_t attr_column = UINT64_MAX;
-	uint64_t content_line = UINT64_MAX;
-	uint64_t content_column = UINT64_MAX;
+	std::string_view content;	// in the source or its rebuilt values, in the arena for defaults
+	TypedValue value;
+	uint32_t attr_offset = UINT32_MAX;
+	uint32_t content_offset = UINT32_MAX;	// first byte of the value, after the quote
+};
+
+/**
+ * Attributes of a Node sorted by Symbol, in the order of the std::map it
+ * replaces. The entries are a run in the NodeArena of the root, so the many
+ * tags without attributes store nothing but an empty view.
+ */
+class AttributeMap
+{
+public:
+	using value_type = std::pair<Symbol, AttributeInfos>;
+	using iterator = value_type *;
+	using const_iterator = const value_type *;
+
+	AttributeMap() = default;
+	explicit AttributeMap(std::span<value_type> entries) : data_(entries.data()), size_(static_cast<uint32_t>(entries.size())) {}
+
+	iterator begin() { return data_; }
+	iterator end() { return data_ + size_; }
+	const_iterator begin() const { return data_; }
+	const_iterator end() const { return data_ + size_; }
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	iterator find(Symbol name)
+	{
+		iterator it = std::lower_bound(begin(), end(), name, [](const value_type& entry, Symbol key) { return entry.first < key; });
+		return (it != end() && it->first == name) ? it : end();
+	}
+
+	const_iterator find(Symbol name) const
+	{
+		return const_cast<AttributeMap *>(this)->find(name);
+	}
+
+private:
+	value_type *data_ = nullptr;
+	uint32_t size_ = 0;
 };
 
+/**
+ * Element of a TDR AST, 64 bytes. The children of a node are a contiguous
+ * run of nodes in the NodeArena of its Ast, which must outlive every node
+ * of the tree (copies of a node share its children), and so are its
+ * attributes. Its text is a span of its source.
+ */
 class Node
 {
 private:
-	std::string identifier_;
-	std::vector<Node> children_;
-	mutable std::map<std::string, AttributeInfos> attributes_;
-	std::string text_;
+	Symbol identifier_;
+	uint32_t childCount_ = 0;
+	Node *children_ = nullptr;
+	AttributeMap::value_type *attributes_ = nullptr;
+	uint32_t attributeCount_ = 0;
+	bool textRebuilt_ = false;			// the text is a value rebuilt by the lexer, textLength_ is its index
+	const TokenSource *source_ = nullptr;
+	const TypedValue *textValue_ = nullptr;	// in the arena, null until the analyzer decodes the text
+
+	// Byte offsets in source_, UINT32_MAX when absent
+	uint32_t beginOffset_ = UINT32_MAX;		// first identifier of the tag, its name unless missing
+	uint32_t textOffset_ = UINT32_MAX;		// text block
+	uint32_t textLength_ = 0;
+	uint32_t endNameOffset_ = UINT32_MAX;	// name in the matching end tag
 
-	std::vector<Token> tokens_;
+	std::span<Node> children() { return { children_, childCount_ }; }
+	AttributeMap attributes() { return AttributeMap({ attributes_, attributeCount_ }); }
 
-	friend Node parser(std::vector<Token>& list, ErrorCollector& errors);
+	void setAttributes(std::span<AttributeMap::value_type> run)
+	{
+		attributes_ = run.data();
+		attributeCount_ = static_cast<uint32_t>(run.size());
+	}
 
-	friend void semanticAnalyzer(Node& ast, SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& baseDir);
-	friend void analyzeNodes(Node& parent, const TagSchema& parentSchema, ErrorCollector& errors, const std::string& baseDir);
-	friend void analyseAttributes(const Node& tag, const TagSchema& tagSchema, ErrorCollector& errors, const std::string& baseDir);
-	friend TagSchema buildEffectiveSchema(const TagSchema& base, const Node& node);
+	friend Ast parser(TokenStream& tokens, ErrorCollector& errors, ParseContext& context);
+	friend Ast parseParallel(TokenSource& source, ErrorCollector& errors, ParseContext& context);
+
+	friend void analyzeNodes(Node& parent, const TagSchema& parentSchema, NodeArena& arena, ErrorCollector& errors, const std::string& baseDir);
+	friend void analyseAttributes(Node& tag, const TagSchema& tagSchema, ErrorCollector& errors, const std::string& baseDir);
+	friend void addDefaultAttributes(Node& node, const TagSchema& schema, NodeArena& arena);
 	friend class SceneLoader;
 
 public:
-	Node(const std::string& identifier = "root") : identifier_(identifier) {}
-	~Node() {}
+	Node(Symbol identifier = sym::root) : identifier_(identifier) {}
+
+	const std::string& getIdentifier() const { return nameOf(identifier_); }
+	Symbol getSymbol() const { return identifier_; }
+	std::span<const Node> getChildren() const { return { children_, childCount_ }; }
+	const AttributeMap getAttributes() const { return AttributeMap({ attributes_, attributeCount_ }); }
+	const TokenSource *getSource() const { return source_; }
 
-	const std::string& getIdentifier() const { return identifier_; }
-	const std::string& getText() const { return text_; }
-	const std::vector<Node>& getChildren() const { return children_; }
-	const std::map<std::string, AttributeInfos>& getAttributes() const { return attributes_; }
-	const std::vector<Token>& getTokens() const { return tokens_; }
+	std::string_view getText() const
+	{
+		if (!source_ || textOffset_ == UINT32_MAX) return {};
+		return source_->value({ TokenType::TEXT, textRebuilt_, textOffset_, textLength_ });
+	}
 
+	const TypedValue& getTextValue() const
+	{
+		static const TypedValue none;
+		return textValue_ ? *textValue_ : none;
+	}
+
+	// Name of a symbol of this node, its identifier or an attribute, local ones included
+	const std::string& nameOf(Symbol symbol) const { return source_ ? source_->symbols().name(symbol) : symbol.str(); }
+
+	uint32_t getNodeBeginOffset() const { return beginOffset_; }
+	uint32_t getEndNameOffset() const { return endNameOffset_; }
 	const std::pair<uint64_t, uint64_t> getNodeBeginPos() const;
 	const std::pair<uint64_t, uint64_t> getTextBeginPos() const;
 
+	// {line, column} of a byte offset in the source of this node, like the ones of its attributes
+	std::pair<uint64_t, uint64_t> getPosition(uint32_t offset) const;
+
 	void print(int nest = 0) const;
 
 };
 
-Node parser(std::vector<Token>& list, ErrorCollector& errors);
+/**
+ * Root of an AST, the only node owning anything: the NodeArena of the tree
+ * and a share of its source when the source is shared. The other nodes, and
+ * copies of the root as a Node, are views that must not outlive it.
+ */
+class Ast : public Node
+{
+private:
+	std::shared_ptr<NodeArena> arena_;
+	std::shared_ptr<const TokenSource> sourceOwner_;	// keeps source_ alive when shared
+
+	friend Ast parser(TokenStream& tokens, ErrorCollector& errors, ParseContext& context);
+	friend Ast parseParallel(TokenSource& source, ErrorCollector& errors, ParseContext& context);
+	friend void semanticAnalyzer(Ast& ast, const SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& baseDir);
+	friend class SceneLoader;
+};
+
+/**
+ * Flat storage of the nodes of an AST, freed in one shot with its root.
+ * Nodes are stored in runs that never move, one per child list, and so are
+ * the attributes, one run per tag having any.
+ */
+class NodeArena
+{
+public:
+	NodeArena() = default;
+	NodeArena(const NodeArena&) = delete;
+	NodeArena& operator=(const NodeArena&) = delete;
+
+	// Moves @p nodes into one contiguous run and returns it
+	std::span<Node> store(std::span<Node> nodes) { return nodes_.store(nodes); }
+	std::span<AttributeMap::value_type> store(std::span<AttributeMap::value_type> attributes) { return attributes_.store(attributes); }
+
+	// Copy of a value found in no source, like a default filled in by the analyzer
+	std::string_view copy(std::string_view value) { return strings_.emplace_back(value); }
+
+	// Value decoded from the text of a node, which stays at the same address
+	const TypedValue *store(const TypedValue& value) { return &values_.emplace_back(value); }
+
+	// Keeps another arena alive, for nodes grafted from another tree
+	void keep(std::shared_ptr<NodeArena> other) { kept_.push_back(std::move(other)); }
+
+	// Keeps the source of grafted nodes alive
+	void keep(std::shared_ptr<const TokenSource> source) { keptSources_.push_back(std::move(source)); }
+
+	// Destroys every node but keeps the blocks for the next tree
+	void clear();
+
+private:
+	template <typename T>
+	class Runs
+	{
+	public:
+		std::span<T> store(std::span<T> items);
+		void clear();
+
+	private:
+		static constexpr size_t blockSize = 4096;
+
+		std::vector<T>& blockFor(size_t count);
+
+		std::vector<std::vector<T>> blocks_;		// filled in order, blocks_[current_] is being filled
+		size_t current_ = 0;
+		std::vector<std::vector<T>> longRuns_;		// one per long run, the first longRunsUsed_ are in use
+		size_t longRunsUsed_ = 0;
+	};
+
+	Runs<Node> nodes_;
+	Runs<AttributeMap::value_type> attributes_;
+	std::deque<std::string> strings_;
+	std::deque<TypedValue> values_;
+	std::vector<std::shared_ptr<NodeArena>> kept_;
+	std::vector<std::shared_ptr<const TokenSource>> keptSources_;
+};
+
+/**
+ * Storage reused from one parse to the next, for callers parsing the same
+ * document over and over, like the language server on every keystroke.
+ * Sources and arenas go back to the pool once no ParseResult or Node holds
+ * them anymore (a root shares its source and arena with all its copies),
+ * and are then reset instead of freed, so steady state reparses barely
+ * allocate. Not thread safe: one context per thread.
+ */
+class ParseContext
+{
+public:
+	ParseContext() = default;
+	ParseContext(const ParseContext&) = delete;
+	ParseContext& operator=(const ParseContext&) = delete;
+
+	// A source holding a copy of @p content
+	std::shared_ptr<TokenSource> acquireSource(std::string_view content);
+
+	// An empty arena
+	std::shared_ptr<NodeArena> acquireArena();
+
+private:
+	static constexpr size_t poolSize = 4;
+
+	std::vector<std::shared_ptr<TokenSource>> sources_;
+	std::vector<std::shared_ptr<NodeArena>> arenas_;
+
+	// Scratch space of parser()
+	std::vector<Node> pending_;
+	std::vector<size_t> open_;
+	std::vector<AttributeMap::value_type> attributes_;
+
+	friend Ast parser(TokenStream& tokens, ErrorCollector& errors, ParseContext& context);
+};
+
+Ast parser(TokenStream& tokens, ErrorCollector& errors, ParseContext& context);
+Ast parser(TokenStream& tokens, ErrorCollector& errors);
+
+/**
+ * Lexes and parses a whole source, on several threads when it is large.
+ * The source is split at lines starting with a tag and lexed in slices,
+ * then top level elements and runs of their children are parsed apart and
+ * stitched back. Whenever a slice or a part reports anything, or the split
+ * guessed wrong, the source is parsed again serially, so the AST and the
+ * diagnostics are always those of parser().
+ */
+Ast parseParallel(TokenSource& source, ErrorCollector& errors, ParseContext& context);
+Ast parseParallel(TokenSource& source, ErrorCollector& errors);
 
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "tdr/schemaData.hpp"
+
+namespace sceneIO::tdr::schema {
+
+/**
+ * Lookups straight into the generated records, through the perfect hashes
+ * of schemaData.hpp: one probe and one key comparison, nothing to build.
+ * Tags are record indices, rootTag for the top level tags. Local symbols
+ * are never schema names. Variants are not indexed, their ranges are short
+ * enough to scan.
+ */
+template <size_t Buckets, size_t Slots, typename KeyOf>
+constexpr uint16_t lookup(const std::array<uint32_t, Buckets>& seeds, const std::array<HashSlot, Slots>& slots,
+                          uint16_t owner, Symbol key, KeyOf keyOf)
+{
+	if (key.local()) return noRecord;
+
+	const uint32_t hash = hashKey(owner, key);
+	const HashSlot& slot = slots[slotOf(hash, seeds[hash & (Buckets - 1)], Slots)];
+
+	if (slot.record == noRecord || slot.owner != owner || keyOf(slot.record) != key) return noRecord;
+	return slot.record;
+}
+
+// Index of the child @p key of the tag @p parent, includes applied, noRecord if there is none
+constexpr uint16_t findChild(uint16_t parent, Symbol key)
+{
+	return lookup(childLookupSeeds, childLookupSlots, parent, key,
+		[](uint16_t record) { return tags[record].key; });
+}
+
+// Index of the attribute @p key of the tag @p tag, noRecord if there is none
+constexpr uint16_t findAttribute(uint16_t tag, Symbol key)
+{
+	return lookup(attributeLookupSeeds, attributeLookupSlots, tag, key,
+		[](uint16_t record) { return attributes[record].key; });
+}
+
+// Index of @p tag in tags
+constexpr uint16_t indexOf(const TagSchema& tag)
+{
+	return static_cast<uint16_t>(&tag - tags.data());
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "tdr/SceneSchema.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace sceneIO::tdr::schema {
+
+/**
+ * Tables of the schema records of SceneSchema.hpp. schemaData.hpp, generated
+ * from schema.json at build time by cmake/generateSchema.cmake, holds one
+ * constexpr array per record type, the lists of records being ranges of
+ * tagLists and attributeLists. Besides the tags as written, tags holds each
+ * variant merged into its tag, and last the root, rootTag. It also holds
+ * the perfect hashes behind the lookups of schemaLookup.hpp, keyed by
+ * symbol IDs.
+ */
+
+// Index of no record
+inline constexpr uint16_t noRecord = UINT16_MAX;
+
+/**
+ * Slot of a perfect hash table: a key of @p owner, found at @p record.
+ * The key itself is read back from the record.
+ */
+struct HashSlot
+{
+	uint16_t owner;
+	uint16_t record;
+};
+
+// FNV-1a of the two bytes of @p owner then of the four of the ID of @p key
+constexpr uint32_t hashKey(uint16_t owner, Symbol key)
+{
+	uint32_t hash = 2166136261u;
+	auto add = [&hash](uint8_t byte) { hash = (hash ^ byte) * 16777619u; };
+
+	add(static_cast<uint8_t>(owner & 0xFF));
+	add(static_cast<uint8_t>(owner >> 8));
+	for (int shift = 0; shift < 32; shift += 8)
+		add(static_cast<uint8_t>(key.id() >> shift));
+	return hash;
+}
+
+// Slot of @p hash displaced by @p seed, in a table of @p size slots (a power of two)
+constexpr uint32_t slotOf(uint32_t hash, uint32_t seed, size_t size)
+{
+	uint32_t mixed = (hash ^ seed) * 73244475u;
+	return (mixed ^ (mixed >> 16)) & static_cast<uint32_t>(size - 1);
+}
+
+}
@@ -1,43 +1,28 @@
 #include "tdr/semanticAnalyzer.hpp"
 #include "tdr/SceneSchema.hpp"
 
-#include "core-utils.hpp"
-
+#include <array>
 #include <charconv>
 #include <filesystem>
 #include <algorithm>
 
 namespace sceneIO::tdr {
 
-static bool isValidByte(const std::string& s)
+static bool isValidByte(std::string_view s, float& channel)
 {
-	if (s.empty()) return false;
-
 	int value;
-	auto [ptr, ec] = std::from_chars(
-		s.data(),
-		s.data() + s.size(),
-		value
-	);
-
-	return ec == std::errc() && ptr == s.data() + s.size() && value >= 0 && value <= 255;
+	if (!isValidValue(s, value) || value < 0 || value > 255) return false;
+	channel = value / 255.0f;
+	return true;
 }
 
-static bool isValidFloatColor(const std::string& s)
+static bool isValidFloatColor(std::string_view s, float& channel)
 {
-	if (s.empty()) return false;
-
-	float value;
-	auto [ptr, ec] = std::from_chars(
-		s.data(),
-		s.data() + s.size(),
-		value
-	);
-
-	return ec == std::errc() && ptr == s.data() + s.size() && value >= 0.0 && value <= 1.0;
+	return isValidValue(s, channel) && channel >= 0.0 && channel <= 1.0;
 }
 
-bool isValidColor(const std::string& s)
+// "#rrggbb", "r,g,b" bytes or "r g b" floats in [0, 1], decoded into @p rgb in [0, 1]
+bool isValidColor(std::string_view s, std::array<float, 3>& rgb)
 {
 	if (s.empty()) return false;
 
@@ -45,22 +30,25 @@ bool isValidColor(const std::string& s)
 	{
 		for (size_t i = 1; i < 7; ++i)
 			if (!std::isxdigit(static_cast<unsigned char>(s[i]))) return false;
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			int value = 0;
+			std::from_chars(s.data() + 1 + 2 * i, s.data() + 3 + 2 * i, value, 16);
+			rgb[i] = value / 255.0f;
+		}
 		return true;
 	}
 
-	std::vector<std::string> parts = cu::string::split(s, ',');
-	if (parts.size() == 3)
-		return isValidByte(parts[0]) && isValidByte(parts[1]) && isValidByte(parts[2]);
-	else
-	{
-		parts = cu::string::split(s, ' ');
-		if (parts.size() == 3)
-			return isValidFloatColor(parts[0]) && isValidFloatColor(parts[1]) && isValidFloatColor(parts[2]);
-	}
+	std::array<std::string_view, 3> parts;
+	if (splitFields(s, ',', parts) == 3)
+		return isValidByte(parts[0], rgb[0]) && isValidByte(parts[1], rgb[1]) && isValidByte(parts[2], rgb[2]);
+	else if (splitFields(s, ' ', parts) == 3)
+		return isValidFloatColor(parts[0], rgb[0]) && isValidFloatColor(parts[1], rgb[1]) && isValidFloatColor(parts[2], rgb[2]);
 	return false;
 }
 
-std::string isValidFilePath(const std::string& pathStr, const std::string& baseDir)
+std::string isValidFilePath(std::string_view pathStr, const std::string& baseDir)
 {
 	if (pathStr.empty()) return "Invalid file path: path is empty";
 
@@ -95,8 +83,41 @@ std::string isValidFilePath(const std::string& pathStr, const std::string& baseD
 	return "";
 }
 
-const std::string validType(ValueType type, const std::optional<std::pair<float, float>>& attrRange, const std::vector<std::string>& attrEnum, const std::string& param, ErrorCollector& errors, const std::string& baseDir)
+// Messages are only built once a value is rejected
+static std::string invalidParameter(std::string_view param, std::string_view reason)
+{
+	std::string res = "Invalid parameter '";
+	res += param;
+	res += "'. ";
+	res += reason;
+	return res;
+}
+
+static std::string invalidNumber(std::string_view param, std::string_view number)
+{
+	std::string res = invalidParameter(param, "'");
+	res += number;
+	res += "' is not a valid number.";
+	return res;
+}
+
+static std::string outOfRange(std::string_view message, const std::pair<float, float>& range)
 {
+	std::string res(message);
+	res += "Value must be between " + std::to_string(range.first) + " and " + std::to_string(range.second);
+	return res;
+}
+
+static bool inRange(float value, const std::optional<std::pair<float, float>>& range)
+{
+	return !range.has_value() || (value <= range->second && value >= range->first);
+}
+
+// Stores the decoded value in @p value when @p param is valid, clears it otherwise
+const std::string validType(ValueType type, const std::optional<std::pair<float, float>>& attrRange, std::span<const std::string_view> attrEnum, std::string_view param, TypedValue& value, ErrorCollector& errors, const std::string& baseDir)
+{
+	value = std::monostate();
+
 	switch (type)
 	{
 		case ValueType::STRING: return "";
@@ -105,57 +126,48 @@ const std::string validType(ValueType type, const std::optional<std::pair<float,
 			float val = 0;
 
 			if (!isValidValue(param, val)) break;
-			if (attrRange.has_value())
-			{
-				if (val > attrRange.value().second || val < attrRange.value().first)
-					return "Invalid parameter '" + param + "'. Value must be between " + std::to_string(attrRange.value().first) + " and " + std::to_string(attrRange.value().second);
-			}
+			if (!inRange(val, attrRange))
+				return outOfRange(invalidParameter(param, ""), *attrRange);
+			value = val;
 			return "";
 		}
 		case ValueType::INT:
 		{
 			int val = 0;
 			if (!isValidValue(param, val)) break;
-			if (attrRange.has_value())
-			{
-				if (val > attrRange.value().second || val < attrRange.value().first)
-					return "Invalid parameter '" + param + "'. Value must be between " + std::to_string(attrRange.value().first) + " and " + std::to_string(attrRange.value().second);
-			}
+			if (!inRange(val, attrRange))
+				return outOfRange(invalidParameter(param, ""), *attrRange);
+			value = val;
 			return "";
 		}
 		case ValueType::BOOL:
 		{
-			if (param == "1" || param == "0" || param == "true" || param == "false") return "";
-			break;
+			if (param == "1" || param == "true") value = true;
+			else if (param == "0" || param == "false") value = false;
+			else break;
+			return "";
 		}
 		case ValueType::VEC3:
 		{
-			auto parts = cu::string::split(param, ' ');
-
-			float val0 = 0;
-			float val1 = 0;
-			float val2 = 0;
-
-			if (parts.size() != 3) return "Invalid parameter '" + param + "'. Wrong amount of numbers for a vec3.";
-			if (!isValidValue(parts[0], val0)) return "Invalid parameter '" + param + "'. '" + parts[0] + "' is not a valid number.";
-			if (!isValidValue(parts[1], val1)) return "Invalid parameter '" + param + "'. '" + parts[1] + "' is not a valid number.";
-			if (!isValidValue(parts[2], val2)) return "Invalid parameter '" + param + "'. '" + parts[2] + "' is not a valid number.";
-			
-			if (attrRange.has_value())
-			{
-				if (val0 > attrRange.value().second || val0 < attrRange.value().first)
-					return "Invalid parameter '" + param + "'. '" + parts[0] + "' is not a valid number. Value must be between " + std::to_string(attrRange.value().first) + " and " + std::to_string(attrRange.value().second);
-				if (val1 > attrRange.value().second || val1 < attrRange.value().first)
-					return "Invalid parameter '" + param + "'. '" + parts[1] + "' is not a valid number. Value must be between " + std::to_string(attrRange.value().first) + " and " + std::to_string(attrRange.value().second);
-				if (val2 > attrRange.value().second || val2 < attrRange.value().first)
-					return "Invalid parameter '" + param + "'. '" + parts[2] + "' is not a valid number. Value must be between " + std::to_string(attrRange.value().first) + " and " + std::to_string(attrRange.value().second);
-			}
+			std::array<std::string_view, 3> parts;
+			std::array<float, 3> vals = { 0, 0, 0 };
+
+			if (splitFields(param, ' ', parts) != 3) return invalidParameter(param, "Wrong amount of numbers for a vec3.");
+
+			for (size_t i = 0; i < 3; i++)
+				if (!isValidValue(parts[i], vals[i])) return invalidNumber(param, parts[i]);
+
+			for (size_t i = 0; i < 3; i++)
+				if (!inRange(vals[i], attrRange)) return outOfRange(invalidNumber(param, parts[i]) + " ", *attrRange);
+			value = vals;
 			return "";
 		}
 		case ValueType::COLOR:
 		{
-			if (isValidColor(param)) return "";
-			break;
+			std::array<float, 3> rgb = { 0, 0, 0 };
+			if (!isValidColor(param, rgb)) break;
+			value = rgb;
+			return "";
 		}
 		case ValueType::FILEPATH:
 		{
@@ -163,10 +175,19 @@ const std::string validType(ValueType type, const std::optional<std::pair<float,
 		}
 		case ValueType::ENUM:
 		{
-			if (std::find(attrEnum.begin(), attrEnum.end(), param) != attrEnum.end()) return "";
-			std::string res = "Invalid parameter '" + param + "'. Parameter must be one of [";
-			for (const std::string& option : attrEnum)
-				res += "'" + option + "', ";
+			auto match = std::find(attrEnum.begin(), attrEnum.end(), param);
+			if (match != attrEnum.end())
+			{
+				value = EnumIndex{ static_cast<uint32_t>(match - attrEnum.begin()) };
+				return "";
+			}
+			std::string res = invalidParameter(param, "Parameter must be one of [");
+			for (std::string_view option : attrEnum)
+			{
+				res += "'";
+				res += option;
+				res += "', ";
+			}
 			res[res.size() - 2] = ']';
 			res[res.size() - 1] = '.';
 			return res;
@@ -176,31 +197,35 @@ const std::string validType(ValueType type, const std::optional<std::pair<float,
 	return "Invalid parameter type. Required: " + printValueType(type);
 }
 
-void analyseAttributes(const Node& tag, const TagSchema& tagSchema, ErrorCollector& errors, const std::string& baseDir)
+void analyseAttributes(Node& tag, const TagSchema& tagSchema, ErrorCollector& errors, const std::string& baseDir)
 {
-	auto& attrs = tag.attributes_;
-	auto& allowedAttrs = tagSchema.attributes;
+	AttributeMap attrs = tag.attributes();
 
 	for (auto attr = attrs.begin(); attr != attrs.end(); attr++)
 	{
-		auto attrSchema = allowedAttrs.find(attr->first);
-		if (attrSchema == allowedAttrs.end())
+		const AttributeSchema *attrSchema = tagSchema.findAttribute(attr->first);
+		if (!attrSchema)
 		{
-			errors.report(TdrError(attr->second.attr_line, attr->second.attr_column, 2, "Unknown property '" + attr->first + "'"));
+			auto pos = tag.getPosition(attr->second.attr_offset);
+			errors.report(TdrError(pos.first, pos.second, 2, "Unknown property '" + tag.nameOf(attr->first) + "'"));
 			continue ;
 		}
 
-		const std::string typeError = validType(attrSchema->second.type, attrSchema->second.range, attrSchema->second.enum_values, attr->second.content, errors, baseDir);
-		if (!typeError.empty()) errors.report(TdrError(attr->second.content_line, attr->second.content_column, attrSchema->second.type == ValueType::FILEPATH ? 2 : 1, typeError));
+		const std::string typeError = validType(attrSchema->type, attrSchema->range(), attrSchema->enumValues(), attr->second.content, attr->second.value, errors, baseDir);
+		if (!typeError.empty())
+		{
+			auto pos = tag.getPosition(attr->second.content_offset);
+			errors.report(TdrError(pos.first, pos.second, attrSchema->type == ValueType::FILEPATH ? 2 : 1, typeError));
+		}
 	}
 
-	for (auto requiredAttr = allowedAttrs.begin(); requiredAttr != allowedAttrs.end(); requiredAttr++)
+	for (const AttributeSchema& requiredAttr : tagSchema.attributes())
 	{
-		if (!requiredAttr->second.required) continue ;
-		if (attrs.find(requiredAttr->first) == attrs.end())
+		if (!requiredAttr.required) continue ;
+		if (attrs.find(requiredAttr.key) == attrs.end())
 		{
 			auto pos = tag.getNodeBeginPos();
-			errors.report(TdrError(pos.first, pos.second, "Missing required property '" + requiredAttr->first + "'"));
+			errors.report(TdrError(pos.first, pos.second, "Missing required property '" + requiredAttr.key + "'"));
 		}
 	}
 }
@@ -228,140 +253,139 @@ struct TagSchema
 
 void validateMultiplicity(const Node& parent, const TagSchema& parentSchema, ErrorCollector& errors)
 {
-	std::map<std::string, int> tagCounts;
-	
-	for (const auto& child : parent.getChildren())
-		tagCounts[child.getIdentifier()]++;
-	
-	for (const auto& [tagName, count] : tagCounts)
+	auto children = parent.getChildren();
+
+	// Same order as the schema, sorted by tag name
+	for (const TagSchema& tagSchema : parentSchema.children())
 	{
-		auto tagSchemaPair = parentSchema.children.find(tagName);
-		if (tagSchemaPair != parentSchema.children.end())
+		if (tagSchema.allow_multiple) continue;
+
+		auto count = std::count_if(children.begin(), children.end(), [&tagSchema](const Node& child) { return child.getSymbol() == tagSchema.key; });
+		if (count > 1)
 		{
-			if (!tagSchemaPair->second.allow_multiple && count > 1)
-			{
-				auto pos = parent.getNodeBeginPos();
-				errors.report(TdrError(pos.first, pos.second, 1, "Tag '" + tagName + "' appears " + std::to_string(count) + " times but is not allowed to repeat"));
-			}
+			auto pos = parent.getNodeBeginPos();
+			errors.report(TdrError(pos.first, pos.second, 1, "Tag '" + tagSchema.key + "' appears " + std::to_string(count) + " times but is not allowed to repeat"));
 		}
 	}
 }
 
-TagSchema buildEffectiveSchema(const TagSchema& base, const Node& node)
+/**
+ * Gives @p node the defaults of the attributes of @p schema it lacks, when
+ * the schema has variants, for them to be picked and for the loader. The
+ * attributes move to a new run of @p arena, the defaults are copied there.
+ */
+void addDefaultAttributes(Node& node, const TagSchema& schema, NodeArena& arena)
 {
-	if (base.variants.empty())
-		return base;
+	if (schema.variants().empty())
+		return;
 
-	auto& attrs = node.attributes_;
-	auto& allowedAttrs = base.attributes;
-
-	for (const auto& allowed : allowedAttrs)
+	auto missing = [&](const AttributeSchema& allowed)
 	{
-		const std::string& name = allowed.first;
-		const AttributeSchema& schema = allowed.second;
-		if (attrs.find(name) == attrs.end() && schema.default_value.has_value())
-		{
-			const std::string def = *schema.default_value;
-			auto pos = node.getNodeBeginPos();
+		return allowed.has_default && node.getAttributes().find(allowed.key) == node.getAttributes().end();
+	};
 
-			AttributeInfos ai;
-			ai.content = def;
-			ai.attr_line = pos.first;
-			ai.attr_column = pos.second;
-			ai.content_line = pos.first;
-			ai.content_column = pos.second;
+	const auto allowedAttrs = schema.attributes();
+	if (std::none_of(allowedAttrs.begin(), allowedAttrs.end(), missing))
+		return;
 
-			attrs[name] = ai;
-		}
-	}
+	std::vector<AttributeMap::value_type> attrs(node.getAttributes().begin(), node.getAttributes().end());
 
-	for (const auto& variant : base.variants)
+	for (const AttributeSchema& allowed : allowedAttrs)
 	{
-		auto it = attrs.find(variant.discriminator_attr);
-		if (it != attrs.end() && it->second.content == variant.discriminator_value)
-		{
-			TagSchema effective = base;
-
- 			for (const auto& [name, attr] : variant.attributes)
-				effective.attributes[name] = attr;
+		if (!missing(allowed)) continue;
 
-			for (const auto& [name, child] : variant.children)
-				effective.children[name] = child;
+		AttributeInfos ai;
+		ai.content = arena.copy(*allowed.defaultValue());
+		ai.attr_offset = node.getNodeBeginOffset();
+		ai.content_offset = ai.attr_offset;
+		attrs.emplace_back(allowed.key, ai);
+	}
 
-			if (variant.allow_text)
-			{
-				effective.allow_text = variant.allow_text;
-				effective.text_type = variant.text_type;
-			}
+	std::sort(attrs.begin(), attrs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	node.setAttributes(arena.store(attrs));
+}
 
-			effective.enum_values = variant.enum_values;
-			effective.range = variant.range;
+const TagSchema *buildEffectiveSchema(const TagSchema& base, const Node& node)
+{
+	const AttributeMap& attrs = node.getAttributes();
 
-			effective.variants.clear();
-			effective.fromCondition = std::make_pair(variant.discriminator_attr, variant.discriminator_value);
+	for (const ConditionalVariant& variant : base.variants())
+	{
+		auto it = attrs.find(variant.discriminator_attr);
+		if (it == attrs.end() || it->second.content != variant.discriminator_value)
+			continue;
 
-			return effective;
-		}
+		return &variant.effective();
 	}
-	return base;
+	return &base;
 }
 
-void analyzeNodes(Node& parent, const TagSchema& parentSchema, ErrorCollector& errors, const std::string& baseDir)
+void analyzeNodes(Node& parent, const TagSchema& parentSchema, NodeArena& arena, ErrorCollector& errors, const std::string& baseDir)
 {
-	for (auto& node : parent.children_)
+	for (auto& node : parent.children())
 	{
-		auto tagSchemaPair = parentSchema.children.find(node.identifier_);
-		if (tagSchemaPair == parentSchema.children.end())
+		const TagSchema *tagSchema = parentSchema.findChild(node.identifier_);
+		if (!tagSchema)
 		{
 			auto pos = node.getNodeBeginPos();
-			errors.report(TdrError(pos.first, pos.second, 1, "Unknown identifier '" + node.identifier_ + "'"));
+			errors.report(TdrError(pos.first, pos.second, 1, "Unknown identifier '" + node.getIdentifier() + "'"));
 			continue ;
 		}
 
-		TagSchema effectiveSchema = buildEffectiveSchema(tagSchemaPair->second, node);
+		addDefaultAttributes(node, *tagSchema, arena);
+		const TagSchema& effectiveSchema = *buildEffectiveSchema(*tagSchema, node);
 
-		auto pos = node.getTextBeginPos();
 		if (!effectiveSchema.allow_text && !node.getText().empty())
 		{
-			errors.report(TdrError(pos.first, pos.second, 1, "Text is not allowed in '" + node.identifier_ + "'"));
+			auto pos = node.getTextBeginPos();
+			errors.report(TdrError(pos.first, pos.second, 1, "Text is not allowed in '" + node.getIdentifier() + "'"));
 		}
-		else if (effectiveSchema.text_type.has_value())
+		else if (effectiveSchema.has_text_type)
 		{
-			const std::string typeError = validType(effectiveSchema.text_type.value(), effectiveSchema.range, effectiveSchema.enum_values, node.getText(), errors, baseDir);
-			if (!typeError.empty()) errors.report(TdrError(pos.first, pos.second, effectiveSchema.text_type.value() == ValueType::FILEPATH ? 2 : 1, typeError));
+			TypedValue value;
+			const std::string typeError = validType(effectiveSchema.text_type, effectiveSchema.range(), effectiveSchema.enumValues(), node.getText(), value, errors, baseDir);
+			if (!std::holds_alternative<std::monostate>(value))
+				node.textValue_ = arena.store(value);
+			if (!typeError.empty())
+			{
+				auto pos = node.getTextBeginPos();
+				errors.report(TdrError(pos.first, pos.second, effectiveSchema.text_type == ValueType::FILEPATH ? 2 : 1, typeError));
+			}
 		}
 
 		analyseAttributes(node, effectiveSchema, errors, baseDir);
-		analyzeNodes(node, effectiveSchema, errors, baseDir);
+		analyzeNodes(node, effectiveSchema, arena, errors, baseDir);
 	}
 
 	validateMultiplicity(parent, parentSchema, errors);
 
-	TagSchema effectiveParentSchema = buildEffectiveSchema(parentSchema, parent);
+	const TagSchema& effectiveParentSchema = *buildEffectiveSchema(parentSchema, parent);
 
-	for (auto requiredTag = effectiveParentSchema.children.begin(); requiredTag != effectiveParentSchema.children.end(); requiredTag++)
+	for (const TagSchema& requiredTag : effectiveParentSchema.children())
 	{
-		if (!requiredTag->second.required) continue ;
+		if (!requiredTag.required) continue ;
 		auto childExists = std::any_of(
-			parent.children_.begin(), 
-			parent.children_.end(),
-			[&requiredTag](const Node& child) { return child.identifier_ == requiredTag->first; }
+			parent.getChildren().begin(), 
+			parent.getChildren().end(),
+			[&requiredTag](const Node& child) { return child.identifier_ == requiredTag.key; }
 		);
 		if (!childExists)
 		{
 			auto pos = parent.getNodeBeginPos();
-			errors.report(TdrError(pos.first, pos.second, "Missing required tag '" + requiredTag->first + "'"));
+			errors.report(TdrError(pos.first, pos.second, "Missing required tag '" + requiredTag.key + "'"));
 		}
 	}
 }
 
-void semanticAnalyzer(Node& ast, SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& filePath)
+void semanticAnalyzer(Ast& ast, const SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& filePath)
 {
 	namespace fs = std::filesystem;
 	std::string baseDir;
 	if (!filePath.empty())
 		baseDir = fs::path(filePath).parent_path().string();
-	analyzeNodes(ast, sceneSchema.root, errors, baseDir);
+	if (!ast.arena_)
+		ast.arena_ = std::make_shared<NodeArena>();
+	analyzeNodes(ast, sceneSchema.getRoot(), *ast.arena_, errors, baseDir);
 }
 
 }
\ No newline at end of file
@@ -4,12 +4,15 @@
 #include "tdr/error.hpp"
 #include "tdr/SceneSchema.hpp"
 
+#include <algorithm>
+#include <array>
 #include <charconv>
+#include <string_view>
 
 namespace sceneIO::tdr {
 
 template <typename T>
-bool isValidValue(const std::string& s, T& value)
+bool isValidValue(std::string_view s, T& value)
 {
 	static_assert(std::is_arithmetic_v<T>, "T must be arithmetic");
 	
@@ -24,8 +27,34 @@ bool isValidValue(const std::string& s, T& value)
 	return ec == std::errc() && ptr == s.data() + s.size();
 }
 
-TagSchema buildEffectiveSchema(const TagSchema& base, const Node& node);
+/**
+ * Splits @p s at runs of @p separator, like cu::string::split but without
+ * allocating: the first fields are stored as views of @p s in @p fields, and
+ * the number of fields is returned, even past the size of @p fields.
+ */
+template <size_t N>
+size_t splitFields(std::string_view s, char separator, std::array<std::string_view, N>& fields)
+{
+	size_t count = 0;
+	size_t pos = 0;
+
+	while ((pos = s.find_first_not_of(separator, pos)) != std::string_view::npos)
+	{
+		size_t end = std::min(s.find(separator, pos), s.size());
+		if (count < N) fields[count] = s.substr(pos, end - pos);
+		count++;
+		pos = end;
+	}
+	return count;
+}
+
+/**
+ * Schema of @p node: the precompiled variant of @p base matching its
+ * discriminator, @p base itself if none. Defaults count once the analyzer
+ * has filled them in.
+ */
+const TagSchema *buildEffectiveSchema(const TagSchema& base, const Node& node);
 
-void semanticAnalyzer(Node& ast, SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& filePath = "");
+void semanticAnalyzer(Ast& ast, const SceneSchema& sceneSchema, ErrorCollector& errors, const std::string& filePath = "");
 
 }
\ No newline at end of file
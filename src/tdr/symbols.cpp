@@ -0,0 +1,132 @@
+#include "tdr/symbols.hpp"
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sceneIO::tdr {
+
+namespace {
+
+class SymbolTable
+{
+public:
+	SymbolTable()
+	{
+		add("");
+#define TDR_SYMBOL_NAME(name) add(#name);
+		TDR_KNOWN_SYMBOLS(TDR_SYMBOL_NAME)
+#undef TDR_SYMBOL_NAME
+#define TDR_SYMBOL_LITERAL(name) add(name);
+		TDR_OTHER_SYMBOLS(TDR_SYMBOL_LITERAL)
+#undef TDR_SYMBOL_LITERAL
+	}
+
+	uint32_t find(std::string_view name) const
+	{
+		std::shared_lock lock(mutex_);
+		auto it = ids_.find(name);
+		return it == ids_.end() ? sym::EMPTY : it->second;
+	}
+
+	uint32_t intern(std::string_view name)
+	{
+		{
+			std::shared_lock lock(mutex_);
+			auto it = ids_.find(name);
+			if (it != ids_.end()) return it->second;
+		}
+
+		std::unique_lock lock(mutex_);
+		auto it = ids_.find(name);
+		if (it != ids_.end()) return it->second;
+		return add(name);
+	}
+
+	const std::string& name(uint32_t id) const
+	{
+		std::shared_lock lock(mutex_);
+		return names_[id];
+	}
+
+private:
+	uint32_t add(std::string_view name)
+	{
+		if (names_.size() >= Symbol::localBase) throw std::length_error("Too many symbols");
+
+		uint32_t id = static_cast<uint32_t>(names_.size());
+		const std::string& stored = names_.emplace_back(name);
+		ids_.emplace(stored, id);
+		return id;
+	}
+
+	mutable std::shared_mutex mutex_;
+	std::deque<std::string> names_;							// stable addresses, keys of ids_ point into it
+	std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+SymbolTable& table()
+{
+	static SymbolTable instance;
+	return instance;
+}
+
+}
+
+const std::string& Symbol::str() const
+{
+	static const std::string unknown;
+
+	assert(!local() && "the name of a local symbol is in its SymbolScope");
+	if (local()) return unknown;
+	return table().name(id_);
+}
+
+Symbol Symbol::find(std::string_view name)
+{
+	Symbol res;
+	res.id_ = table().find(name);
+	return res;
+}
+
+uint32_t Symbol::intern(std::string_view name)
+{
+	return table().intern(name);
+}
+
+Symbol SymbolScope::get(std::string_view name)
+{
+	Symbol global = Symbol::find(name);
+	if (global != sym::EMPTY || name.empty()) return global;
+
+	std::lock_guard lock(mutex_);
+	auto it = ids_.find(name);
+	if (it != ids_.end()) return Symbol::fromId(it->second);
+
+	if (names_.size() >= UINT32_MAX - Symbol::localBase) throw std::length_error("Too many symbols");
+
+	uint32_t id = Symbol::localBase + static_cast<uint32_t>(names_.size());
+	const std::string& stored = names_.emplace_back(name);
+	ids_.emplace(stored, id);
+	return Symbol::fromId(id);
+}
+
+const std::string& SymbolScope::name(Symbol symbol) const
+{
+	if (!symbol.local()) return symbol.str();
+
+	std::lock_guard lock(mutex_);
+	return names_[symbol.id() - Symbol::localBase];
+}
+
+void SymbolScope::clear()
+{
+	std::lock_guard lock(mutex_);
+	ids_.clear();
+	names_.clear();
+}
+
+}
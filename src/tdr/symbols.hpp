@@ -0,0 +1,131 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "tdr/schemaSymbols.hpp"
+
+namespace sceneIO::tdr {
+
+/**
+ * TDR_KNOWN_SYMBOLS lists every tag and attribute name of schema.json, and
+ * TDR_OTHER_SYMBOLS those that are not C++ identifiers, both generated at
+ * build time by cmake/generateSchema.cmake. They are interned first, in this
+ * order, so the IDs of the known ones are compile time constants (sym::name).
+ */
+namespace sym {
+
+enum Known : uint32_t
+{
+	EMPTY = 0,
+#define TDR_SYMBOL_ENUM(name) name,
+	TDR_KNOWN_SYMBOLS(TDR_SYMBOL_ENUM)
+#undef TDR_SYMBOL_ENUM
+	KNOWN_COUNT
+};
+
+}
+
+/**
+ * Interned tag / attribute name: a dense 32-bit ID, compared and ordered as
+ * an integer. IDs below localBase index a process wide symbol table, whose
+ * names are never released, so only schema names belong there: names met
+ * while parsing that are not interned yet get IDs from localBase up in the
+ * SymbolScope of their source instead, and only compare with symbols of
+ * that source. Interning and str() are thread safe.
+ */
+class Symbol
+{
+public:
+	static constexpr uint32_t localBase = 0x80000000u;
+
+	constexpr Symbol() = default;
+	constexpr Symbol(sym::Known known) : id_(known) {}
+
+	// Interns @p name in the process wide table, Symbol::find() for lookups
+	explicit Symbol(std::string_view name) : id_(intern(name)) {}
+	explicit Symbol(const std::string& name) : Symbol(std::string_view(name)) {}
+	explicit Symbol(const char *name) : Symbol(std::string_view(name)) {}
+
+	constexpr uint32_t id() const { return id_; }
+
+	// Name of a process wide symbol, those of local ones are kept by their SymbolScope
+	const std::string& str() const;
+
+	// Interned in a SymbolScope rather than process wide
+	constexpr bool local() const { return id_ >= localBase; }
+
+	constexpr size_t hash() const { return id_; }
+
+	constexpr auto operator<=>(const Symbol& other) const = default;
+
+	// Symbol of an already interned name, the empty symbol otherwise
+	static Symbol find(std::string_view name);
+
+private:
+	friend class SymbolScope;
+
+	static constexpr Symbol fromId(uint32_t id)
+	{
+		Symbol res;
+		res.id_ = id;
+		return res;
+	}
+
+	static uint32_t intern(std::string_view name);
+
+	uint32_t id_ = sym::EMPTY;
+};
+
+/**
+ * Names of one source that are not in the process wide table, like
+ * misspelled or half typed names in an editor, freed with the source instead
+ * of piling up for the life of the process. Owned by the TokenSource: its
+ * symbols are valid as long as the source. Thread safe, for the parallel
+ * parser.
+ */
+class SymbolScope
+{
+public:
+	SymbolScope() = default;
+	SymbolScope(const SymbolScope&) = delete;
+	SymbolScope& operator=(const SymbolScope&) = delete;
+
+	// The process wide symbol of @p name if there is one, a local one otherwise
+	Symbol get(std::string_view name);
+
+	// Name of @p symbol, local to this scope or process wide
+	const std::string& name(Symbol symbol) const;
+
+	void clear();
+
+private:
+	mutable std::mutex mutex_;
+	std::deque<std::string> names_;							// stable addresses, keys of ids_ point into it
+	std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+inline std::ostream& operator<<(std::ostream& io, const Symbol& symbol)
+{
+	return io << symbol.str();
+}
+
+inline std::string operator+(const std::string& lhs, const Symbol& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const char *lhs, const Symbol& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const Symbol& lhs, const std::string& rhs) { return lhs.str() + rhs; }
+inline std::string operator+(const Symbol& lhs, const char *rhs) { return lhs.str() + rhs; }
+
+}
+
+template<>
+struct std::hash<sceneIO::tdr::Symbol>
+{
+	size_t operator()(const sceneIO::tdr::Symbol& s) const noexcept { return s.hash(); }
+};